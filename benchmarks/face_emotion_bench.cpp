@@ -0,0 +1,251 @@
+// Microbenchmarks for the plugin's per-stage hot paths. Everything here links
+// without libobs: the conversion benchmarks drive the yuv_convert kernels that
+// back ExtractBgrFrame/WriteBgrFrame, the tracker benchmarks call
+// FaceTracker::Update directly, and the inference benchmarks replicate the
+// worker's detector and emotion stages with plain OpenCV calls. The DNN
+// benchmarks need the model files and are skipped unless
+// FACE_EMOTION_BENCH_MODEL_DIR points at a directory containing them.
+//
+// Build with -DENABLE_BENCHMARKS=ON (see CMakeLists.txt).
+
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <opencv2/dnn.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/objdetect/face.hpp>
+
+#include "tracker.hpp"
+#include "yuv_convert.hpp"
+
+namespace {
+
+constexpr const char *kModelDirEnv = "FACE_EMOTION_BENCH_MODEL_DIR";
+constexpr const char *kFaceModelName = "face_detection_yunet_2023mar.onnx";
+constexpr const char *kEmotionModelName = "emotion-ferplus-8.onnx";
+constexpr int kEmotionInputSize = 64;
+
+// Deterministic pseudo-random plane so the kernels see realistic, incompressible data.
+cv::Mat RandomPlane(const int rows, const int cols, const int type)
+{
+  cv::Mat plane(rows, cols, type);
+  cv::RNG rng(0x5EED);
+  rng.fill(plane, cv::RNG::UNIFORM, 0, type == CV_16UC1 ? 1024 : 256);
+  return plane;
+}
+
+void SetFrameRateCounters(benchmark::State &state, const int width, const int height)
+{
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * width * height * 3);
+  state.counters["fps"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+
+void BM_I420ToBgr(benchmark::State &state)
+{
+  const int width = static_cast<int>(state.range(0));
+  const int height = static_cast<int>(state.range(1));
+  const cv::Mat y = RandomPlane(height, width, CV_8UC1);
+  const cv::Mat u = RandomPlane(height / 2, width / 2, CV_8UC1);
+  const cv::Mat v = RandomPlane(height / 2, width / 2, CV_8UC1);
+  cv::Mat bgr(height, width, CV_8UC3);
+
+  for (auto _ : state) {
+    yuv_convert::I420ToBgr(y.data, y.step, u.data, u.step, v.data, v.step, bgr.data, bgr.step, width, height);
+    benchmark::DoNotOptimize(bgr.data);
+  }
+  SetFrameRateCounters(state, width, height);
+}
+
+void BM_BgrToI420(benchmark::State &state)
+{
+  const int width = static_cast<int>(state.range(0));
+  const int height = static_cast<int>(state.range(1));
+  const cv::Mat bgr = RandomPlane(height, width, CV_8UC3);
+  cv::Mat y(height, width, CV_8UC1);
+  cv::Mat u(height / 2, width / 2, CV_8UC1);
+  cv::Mat v(height / 2, width / 2, CV_8UC1);
+
+  for (auto _ : state) {
+    yuv_convert::BgrToI420(bgr.data, bgr.step, y.data, y.step, u.data, u.step, v.data, v.step, width, height);
+    benchmark::DoNotOptimize(y.data);
+  }
+  SetFrameRateCounters(state, width, height);
+}
+
+void BM_BgrToNv12(benchmark::State &state)
+{
+  const int width = static_cast<int>(state.range(0));
+  const int height = static_cast<int>(state.range(1));
+  const cv::Mat bgr = RandomPlane(height, width, CV_8UC3);
+  cv::Mat y(height, width, CV_8UC1);
+  cv::Mat uv(height / 2, width / 2, CV_8UC2);
+
+  for (auto _ : state) {
+    yuv_convert::BgrToNv12(bgr.data, bgr.step, y.data, y.step, uv.data, uv.step, width, height);
+    benchmark::DoNotOptimize(y.data);
+  }
+  SetFrameRateCounters(state, width, height);
+}
+
+void BM_BgrToYuy2(benchmark::State &state)
+{
+  const int width = static_cast<int>(state.range(0));
+  const int height = static_cast<int>(state.range(1));
+  const cv::Mat bgr = RandomPlane(height, width, CV_8UC3);
+  cv::Mat yuy2(height, width, CV_8UC2);
+
+  for (auto _ : state) {
+    yuv_convert::BgrToYuy2(bgr.data, bgr.step, yuy2.data, yuy2.step, width, height);
+    benchmark::DoNotOptimize(yuy2.data);
+  }
+  SetFrameRateCounters(state, width, height);
+}
+
+// The BGRA extraction path is pure OpenCV (resize + cvtColor); benchmarked so
+// format comparisons cover every branch of ExtractBgrFrame.
+void BM_BgraToBgr(benchmark::State &state)
+{
+  const int width = static_cast<int>(state.range(0));
+  const int height = static_cast<int>(state.range(1));
+  const cv::Mat bgra = RandomPlane(height, width, CV_8UC4);
+  cv::Mat bgr;
+
+  for (auto _ : state) {
+    cv::cvtColor(bgra, bgr, cv::COLOR_BGRA2BGR);
+    benchmark::DoNotOptimize(bgr.data);
+  }
+  SetFrameRateCounters(state, width, height);
+}
+
+void BM_Narrow10To8(benchmark::State &state)
+{
+  const int width = static_cast<int>(state.range(0));
+  const int height = static_cast<int>(state.range(1));
+  const cv::Mat y16 = RandomPlane(height, width, CV_16UC1);
+  cv::Mat y8(height, width, CV_8UC1);
+
+  for (auto _ : state) {
+    yuv_convert::Narrow10To8(y16.ptr<uint16_t>(), y16.step, y8.data, y8.step, width, height, 8);
+    benchmark::DoNotOptimize(y8.data);
+  }
+  SetFrameRateCounters(state, width, height);
+}
+
+// Synthetic detections jittered per result, mirroring a steady scene; face
+// count sweeps past the old 3-face ceiling to exercise the assignment solver.
+void BM_TrackerUpdate(benchmark::State &state)
+{
+  const int face_count = static_cast<int>(state.range(0));
+  std::mt19937 rng(0x5EED);
+  std::uniform_int_distribution<int> jitter(-6, 6);
+
+  std::vector<RawFaceDetection> detections;
+  for (int i = 0; i < face_count; ++i) {
+    RawFaceDetection detection;
+    detection.bbox = cv::Rect(120 * (i % 8) + 10, 150 * (i / 8) + 10, 96, 96);
+    detection.probs_raw.fill(1.0f / static_cast<float>(kEmotionClassCount));
+    detections.push_back(detection);
+  }
+
+  FaceTracker tracker;
+  uint64_t timestamp_ns = 0;
+  for (auto _ : state) {
+    for (auto &detection : detections) {
+      detection.bbox.x += jitter(rng);
+      detection.bbox.y += jitter(rng);
+    }
+    timestamp_ns += 33'000'000;
+    benchmark::DoNotOptimize(tracker.Update(detections, timestamp_ns, face_count, 0.6f, 0.3f));
+  }
+}
+
+// CPU-side emotion preprocessing exactly as FillEmotionBlob runs it: gray
+// crop, resize, equalize, convert into one plane of the NCHW batch blob.
+void BM_EmotionPreprocess(benchmark::State &state)
+{
+  const int batch_size = static_cast<int>(state.range(0));
+  const cv::Mat crop = RandomPlane(128, 128, CV_8UC1);
+  const int blob_sizes[] = {batch_size, 1, kEmotionInputSize, kEmotionInputSize};
+  cv::Mat blob(4, blob_sizes, CV_32F);
+  cv::Mat resized;
+
+  for (auto _ : state) {
+    for (int face = 0; face < batch_size; ++face) {
+      cv::Mat plane(kEmotionInputSize, kEmotionInputSize, CV_32F, blob.ptr<float>(face));
+      cv::resize(crop, resized, cv::Size(kEmotionInputSize, kEmotionInputSize), 0.0, 0.0, cv::INTER_LINEAR);
+      cv::equalizeHist(resized, resized);
+      resized.convertTo(plane, CV_32F);
+    }
+    benchmark::DoNotOptimize(blob.data);
+  }
+}
+
+std::string ModelPath(const char *model_name)
+{
+  const char *model_dir = std::getenv(kModelDirEnv);
+  if (model_dir == nullptr || model_dir[0] == '\0') {
+    return {};
+  }
+  return std::string(model_dir) + "/" + model_name;
+}
+
+void BM_FaceDetect(benchmark::State &state)
+{
+  const std::string model_path = ModelPath(kFaceModelName);
+  if (model_path.empty()) {
+    state.SkipWithError("set FACE_EMOTION_BENCH_MODEL_DIR to run the DNN benchmarks");
+    return;
+  }
+
+  const int width = static_cast<int>(state.range(0));
+  const int height = width * 9 / 16;
+  const cv::Mat frame = RandomPlane(height, width, CV_8UC3);
+
+  cv::Ptr<cv::FaceDetectorYN> detector = cv::FaceDetectorYN::create(model_path, "", frame.size(), 0.7f, 0.3f, 5000);
+  cv::Mat faces;
+  for (auto _ : state) {
+    detector->detect(frame, faces);
+    benchmark::DoNotOptimize(faces.data);
+  }
+}
+
+void BM_EmotionForward(benchmark::State &state)
+{
+  const std::string model_path = ModelPath(kEmotionModelName);
+  if (model_path.empty()) {
+    state.SkipWithError("set FACE_EMOTION_BENCH_MODEL_DIR to run the DNN benchmarks");
+    return;
+  }
+
+  const int batch_size = static_cast<int>(state.range(0));
+  cv::dnn::Net net = cv::dnn::readNetFromONNX(model_path);
+  const int blob_sizes[] = {batch_size, 1, kEmotionInputSize, kEmotionInputSize};
+  cv::Mat blob(4, blob_sizes, CV_32F);
+  cv::randu(blob, 0.0f, 255.0f);
+
+  for (auto _ : state) {
+    net.setInput(blob);
+    benchmark::DoNotOptimize(net.forward().data);
+  }
+}
+
+#define FRAME_SIZES ->Args({1280, 720})->Args({1920, 1080})->Args({3840, 2160})
+
+BENCHMARK(BM_I420ToBgr) FRAME_SIZES;
+BENCHMARK(BM_BgrToI420) FRAME_SIZES;
+BENCHMARK(BM_BgrToNv12) FRAME_SIZES;
+BENCHMARK(BM_BgrToYuy2) FRAME_SIZES;
+BENCHMARK(BM_BgraToBgr) FRAME_SIZES;
+BENCHMARK(BM_Narrow10To8) FRAME_SIZES;
+BENCHMARK(BM_TrackerUpdate)->Arg(1)->Arg(4)->Arg(8)->Arg(16);
+BENCHMARK(BM_EmotionPreprocess)->Arg(1)->Arg(4)->Arg(16);
+BENCHMARK(BM_FaceDetect)->Arg(320)->Arg(640);
+BENCHMARK(BM_EmotionForward)->Arg(1)->Arg(4)->Arg(16);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -1,9 +1,12 @@
 #include "face_emotion_filter.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdlib>
 #include <cstring>
 #include <filesystem>
+#include <memory>
 #include <sstream>
 
 #include <util/platform.h>
@@ -13,6 +16,8 @@
 #include <plugin-support.h>
 
 #include "emotion_mapping.hpp"
+#include "inference_service.hpp"
+#include "yuv_convert.hpp"
 
 namespace {
 
@@ -35,6 +40,9 @@ constexpr const char *kSettingBoxColorG = "box_color_g";
 constexpr const char *kSettingBoxColorB = "box_color_b";
 constexpr const char *kSettingBoxThickness = "box_thickness";
 constexpr const char *kSettingShowTrackId = "show_track_id";
+constexpr const char *kSettingRenderMode = "render_mode";
+constexpr const char *kRenderModeCpu = "cpu";
+constexpr const char *kRenderModeGpu = "gpu";
 constexpr const char *kSettingTextUseEmotionColor = "text_use_emotion_color";
 constexpr const char *kSettingTextColorR = "text_color_r";
 constexpr const char *kSettingTextColorG = "text_color_g";
@@ -45,42 +53,154 @@ constexpr const char *kSettingTextThickness = "text_thickness";
 constexpr const char *kSettingTextPadding = "text_padding";
 constexpr const char *kSettingTextBgOpacity = "text_bg_opacity";
 constexpr const char *kSettingLowConfidenceLabel = "low_conf_label";
+constexpr const char *kSettingDnnBackend = "dnn_backend";
+constexpr const char *kDnnBackendAuto = "auto";
+constexpr const char *kDnnBackendCpu = "cpu";
+constexpr const char *kDnnBackendOpenCl = "opencl";
+constexpr const char *kDnnBackendOpenClFp16 = "opencl_fp16";
+constexpr const char *kDnnBackendCuda = "cuda";
+constexpr const char *kSettingMotionThreshold = "motion_threshold";
+constexpr const char *kSettingSyncMode = "sync_mode";
+constexpr const char *kSettingSyncDeadlineMs = "sync_deadline_ms";
+constexpr const char *kSettingAdaptiveWidth = "adaptive_width";
+constexpr const char *kSettingTargetLatencyMs = "target_latency_ms";
+constexpr const char *kSettingWorkerLowPriority = "worker_low_priority";
+constexpr const char *kSettingWorkerAffinityMask = "worker_affinity_mask";
+constexpr const char *kSettingOpenCvThreads = "opencv_threads";
+constexpr const char *kSettingFixedDetectorInput = "fixed_detector_input";
+constexpr const char *kSettingRoiDetection = "roi_detection";
+constexpr const char *kSettingFullSweepInterval = "full_sweep_interval_s";
+constexpr const char *kSettingModelPrecision = "model_precision";
+constexpr const char *kModelPrecisionFp32 = "fp32";
+constexpr const char *kModelPrecisionFp16 = "fp16";
+constexpr const char *kModelPrecisionInt8 = "int8";
 
 constexpr uint64_t kOneSecondNs = 1'000'000'000ULL;
 constexpr uint64_t kPerfLogIntervalNs = 5ULL * kOneSecondNs;
+// Sync mode holds at most this many frames; the deadline normally empties the
+// ring long before, so overflow only triggers on very high-fps sources.
+constexpr std::size_t kSyncRingCapacity = 16;
 
-bool CopyPlaneToLinear(
-  const uint8_t *src,
-  const std::size_t src_stride,
-  uint8_t *dst,
-  const std::size_t row_bytes,
-  const int rows)
+double MillisecondsSince(const std::chrono::steady_clock::time_point start)
 {
-  if (src == nullptr || dst == nullptr || row_bytes == 0 || rows <= 0 || src_stride < row_bytes) {
-    return false;
+  return std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(std::chrono::steady_clock::now() - start)
+    .count();
+}
+
+// p50/p95/p99 of one stage over the current log window; advances the baseline
+// to the captured snapshot so the next window starts here.
+struct StagePercentiles {
+  double p50 = 0.0;
+  double p95 = 0.0;
+  double p99 = 0.0;
+};
+
+StagePercentiles WindowPercentiles(const LatencyHistogram &histogram, LatencyHistogram::Snapshot *baseline)
+{
+  const LatencyHistogram::Snapshot current = histogram.Capture();
+  const StagePercentiles percentiles {
+    LatencyHistogram::Percentile(current, *baseline, 0.50),
+    LatencyHistogram::Percentile(current, *baseline, 0.95),
+    LatencyHistogram::Percentile(current, *baseline, 0.99)};
+  *baseline = current;
+  return percentiles;
+}
+constexpr std::size_t kMaxCachedLabels = 32;
+
+// Fixed-size luma thumbnail for the motion gate: large enough to catch a
+// person entering the shot, small enough that the diff costs microseconds.
+constexpr int kMotionGateWidth = 64;
+constexpr int kMotionGateHeight = 36;
+
+// Inference frames keep the source aspect ratio; dimensions stay even so the
+// 4:2:0 chroma planes divide cleanly.
+cv::Size ComputeTargetSize(const int width, const int height, const int target_width)
+{
+  if (target_width <= 0 || target_width >= width) {
+    return cv::Size(width, height);
   }
 
-  for (int row = 0; row < rows; ++row) {
-    std::memcpy(dst + static_cast<std::size_t>(row) * row_bytes, src + static_cast<std::size_t>(row) * src_stride, row_bytes);
+  const int target_w = std::max(2, target_width & ~1);
+  const double scale = static_cast<double>(target_w) / static_cast<double>(width);
+  const int target_h = std::max(2, static_cast<int>(std::round(height * scale)) & ~1);
+  return cv::Size(target_w, target_h);
+}
+
+// Write-back regions are snapped outward to even coordinates so they stay
+// valid for the subsampled chroma planes.
+cv::Rect AlignRectToEven(const cv::Rect &rect, const int width, const int height)
+{
+  const int x0 = std::clamp(rect.x, 0, width) & ~1;
+  const int y0 = std::clamp(rect.y, 0, height) & ~1;
+  const int x1 = std::min(width, (std::max(rect.x + rect.width, 0) + 1) & ~1);
+  const int y1 = std::min(height, (std::max(rect.y + rect.height, 0) + 1) & ~1);
+  if (x1 <= x0 || y1 <= y0) {
+    return {};
   }
-  return true;
+  return cv::Rect(x0, y0, x1 - x0, y1 - y0);
 }
 
-bool CopyLinearToPlane(
-  const uint8_t *src,
-  uint8_t *dst,
-  const std::size_t dst_stride,
-  const std::size_t row_bytes,
-  const int rows)
+// Upper bound on how far a box is extrapolated past its result timestamp; a
+// stalled worker should freeze the overlay, not slide it offscreen.
+constexpr double kMaxPredictSeconds = 0.5;
+
+// Advances each face's box along its track velocity to the display timestamp
+// so the overlay keeps moving between inference results. Operates on a
+// per-frame copy; the stored results stay at their own timestamps.
+void PredictFaces(std::vector<DetectedFace> *faces, const uint64_t now_ns, const int frame_width, const int frame_height)
 {
-  if (src == nullptr || dst == nullptr || row_bytes == 0 || rows <= 0 || dst_stride < row_bytes) {
-    return false;
+  for (DetectedFace &face : *faces) {
+    if (face.ts_ns == 0 || now_ns <= face.ts_ns) {
+      continue;
+    }
+
+    const double dt_seconds =
+      std::min(kMaxPredictSeconds, static_cast<double>(now_ns - face.ts_ns) / 1'000'000'000.0);
+    const int dx = static_cast<int>(std::lround(face.velocity.x * dt_seconds));
+    const int dy = static_cast<int>(std::lround(face.velocity.y * dt_seconds));
+    if (dx == 0 && dy == 0) {
+      continue;
+    }
+
+    face.bbox.x = std::clamp(face.bbox.x + dx, 1 - face.bbox.width, frame_width - 1);
+    face.bbox.y = std::clamp(face.bbox.y + dy, 1 - face.bbox.height, frame_height - 1);
+  }
+}
+
+// cv::rectangle centers the stroke on the edge, so the touched area extends by
+// the thickness plus the anti-aliasing fringe on both sides. For large boxes
+// only the four edge strips are recorded; the untouched interior never needs
+// conversion.
+void AppendBoxOutlineRects(
+  const cv::Rect &bbox,
+  const int thickness,
+  const cv::Rect &bounds,
+  std::vector<cv::Rect> *rects)
+{
+  const int pad = std::max(1, thickness) + 2;
+  const cv::Rect outer(bbox.x - pad, bbox.y - pad, bbox.width + 2 * pad, bbox.height + 2 * pad);
+  const int strip = 2 * pad;
+
+  if (outer.width <= 2 * strip || outer.height <= 2 * strip) {
+    const cv::Rect clipped = outer & bounds;
+    if (!clipped.empty()) {
+      rects->push_back(clipped);
+    }
+    return;
   }
 
-  for (int row = 0; row < rows; ++row) {
-    std::memcpy(dst + static_cast<std::size_t>(row) * dst_stride, src + static_cast<std::size_t>(row) * row_bytes, row_bytes);
+  const cv::Rect edges[4] = {
+    cv::Rect(outer.x, outer.y, outer.width, strip),
+    cv::Rect(outer.x, outer.y + outer.height - strip, outer.width, strip),
+    cv::Rect(outer.x, outer.y + strip, strip, outer.height - 2 * strip),
+    cv::Rect(outer.x + outer.width - strip, outer.y + strip, strip, outer.height - 2 * strip),
+  };
+  for (const cv::Rect &edge : edges) {
+    const cv::Rect clipped = edge & bounds;
+    if (!clipped.empty()) {
+      rects->push_back(clipped);
+    }
   }
-  return true;
 }
 
 const char *VideoFormatToString(const video_format format)
@@ -156,43 +276,63 @@ void FillRectWithOpacity(cv::Mat *image, const cv::Rect &rect, const cv::Scalar
   cv::addWeighted(overlay, alpha, roi, 1.0 - alpha, 0.0, roi);
 }
 
-void DrawTextWithOpacity(
-  cv::Mat *image,
+std::string BuildLabelKey(
   const std::string &text,
-  const cv::Point &origin,
-  const int font_face,
-  const double font_scale,
-  const cv::Scalar &color,
+  const double scale,
   const int thickness,
-  const int line_type,
+  const cv::Scalar &color,
   const int opacity)
 {
-  if (image == nullptr || image->empty() || text.empty() || opacity <= 0) {
-    return;
-  }
-
-  const int clamped_opacity = std::clamp(opacity, 0, 255);
-  if (clamped_opacity >= 255) {
-    cv::putText(*image, text, origin, font_face, font_scale, color, thickness, line_type);
-    return;
-  }
+  std::ostringstream key_builder;
+  key_builder << scale << '|' << thickness << '|' << static_cast<int>(color[0]) << ',' << static_cast<int>(color[1])
+              << ',' << static_cast<int>(color[2]) << '|' << opacity << '|' << text;
+  return key_builder.str();
+}
 
-  int baseline = 0;
-  const cv::Size text_size = cv::getTextSize(text, font_face, font_scale, thickness, &baseline);
-  const cv::Rect text_rect(origin.x, origin.y - text_size.height, text_size.width + 2, text_size.height + baseline + 2);
-  const cv::Rect frame_bounds(0, 0, image->cols, image->rows);
-  const cv::Rect clipped = text_rect & frame_bounds;
+// Alpha-blit a pre-rendered label sprite. The destination may be BGR or BGRA;
+// the alpha channel of BGRA video frames is left untouched.
+void BlitLabelSprite(cv::Mat *image, const cv::Mat &premultiplied, const cv::Mat &alpha, const int x, const int y)
+{
+  const cv::Rect bounds(0, 0, image->cols, image->rows);
+  const cv::Rect clipped = cv::Rect(x, y, premultiplied.cols, premultiplied.rows) & bounds;
   if (clipped.empty()) {
     return;
   }
 
-  cv::Mat roi = (*image)(clipped);
-  cv::Mat overlay = roi.clone();
-  const cv::Point local_origin(origin.x - clipped.x, origin.y - clipped.y);
-  cv::putText(overlay, text, local_origin, font_face, font_scale, color, thickness, line_type);
+  const int channels = image->channels();
+  for (int row = 0; row < clipped.height; ++row) {
+    uint8_t *dst = image->ptr<uint8_t>(clipped.y + row) + static_cast<std::size_t>(clipped.x) * channels;
+    const uint8_t *src =
+      premultiplied.ptr<uint8_t>(clipped.y + row - y) + static_cast<std::size_t>(clipped.x - x) * 3;
+    const uint8_t *coverage = alpha.ptr<uint8_t>(clipped.y + row - y) + (clipped.x - x);
+    for (int col = 0; col < clipped.width; ++col) {
+      const int inverse = 255 - coverage[col];
+      dst[0] = static_cast<uint8_t>(std::min(255, src[0] + ((dst[0] * inverse + 127) / 255)));
+      dst[1] = static_cast<uint8_t>(std::min(255, src[1] + ((dst[1] * inverse + 127) / 255)));
+      dst[2] = static_cast<uint8_t>(std::min(255, src[2] + ((dst[2] * inverse + 127) / 255)));
+      dst += channels;
+      src += 3;
+    }
+  }
+}
 
-  const double alpha = static_cast<double>(clamped_opacity) / 255.0;
-  cv::addWeighted(overlay, alpha, roi, 1.0 - alpha, 0.0, roi);
+InferenceWorker::DnnBackend ParseDnnBackend(const char *value)
+{
+  if (value != nullptr) {
+    if (std::strcmp(value, kDnnBackendCpu) == 0) {
+      return InferenceWorker::DnnBackend::kCpu;
+    }
+    if (std::strcmp(value, kDnnBackendOpenCl) == 0) {
+      return InferenceWorker::DnnBackend::kOpenCl;
+    }
+    if (std::strcmp(value, kDnnBackendOpenClFp16) == 0) {
+      return InferenceWorker::DnnBackend::kOpenClFp16;
+    }
+    if (std::strcmp(value, kDnnBackendCuda) == 0) {
+      return InferenceWorker::DnnBackend::kCuda;
+    }
+  }
+  return InferenceWorker::DnnBackend::kAuto;
 }
 
 std::string BuildFaceText(const DetectedFace &face, const FilterConfig &config)
@@ -253,42 +393,112 @@ obs_source_frame *FilterVideo(void *data, obs_source_frame *frame)
   return static_cast<FaceEmotionFilter *>(data)->FilterVideo(frame);
 }
 
+void FilterVideoRender(void *data, gs_effect_t *effect)
+{
+  static_cast<FaceEmotionFilter *>(data)->RenderOverlay(effect);
+}
+
+// Solid premultiplied-alpha quad in source coordinates.
+void DrawSolidRect(gs_effect_t *solid, const cv::Rect &rect, const cv::Scalar &bgr, const int opacity)
+{
+  const float alpha = static_cast<float>(std::clamp(opacity, 0, 255)) / 255.0f;
+  struct vec4 color;
+  vec4_set(
+    &color,
+    static_cast<float>(bgr[2]) / 255.0f * alpha,
+    static_cast<float>(bgr[1]) / 255.0f * alpha,
+    static_cast<float>(bgr[0]) / 255.0f * alpha,
+    alpha);
+  gs_effect_set_vec4(gs_effect_get_param_by_name(solid, "color"), &color);
+
+  while (gs_effect_loop(solid, "Solid")) {
+    gs_matrix_push();
+    gs_matrix_translate3f(static_cast<float>(rect.x), static_cast<float>(rect.y), 0.0f);
+    gs_draw_sprite(nullptr, 0, static_cast<uint32_t>(rect.width), static_cast<uint32_t>(rect.height));
+    gs_matrix_pop();
+  }
+}
+
+void DrawTextureSprite(gs_effect_t *effect, gs_texture_t *texture, const int x, const int y)
+{
+  gs_effect_set_texture(gs_effect_get_param_by_name(effect, "image"), texture);
+  while (gs_effect_loop(effect, "Draw")) {
+    gs_matrix_push();
+    gs_matrix_translate3f(static_cast<float>(x), static_cast<float>(y), 0.0f);
+    gs_draw_sprite(texture, 0, 0, 0);
+    gs_matrix_pop();
+  }
+}
+
 } // namespace
 
 FaceEmotionFilter::FaceEmotionFilter(obs_source_t *source) : source_(source)
 {
-  const std::string face_model_path = ResolveModelPath(kFaceModelName);
-  const std::string emotion_model_path = ResolveModelPath(kEmotionModelName);
+  // Results tap for automation: consumers connect to the filter's signal
+  // handler and read the DetectedFace array (src/tracker.hpp) in place during
+  // the callback. The pointer is only valid for the duration of the signal.
+  signal_handler_t *handler = obs_source_get_signal_handler(source_);
+  if (handler != nullptr) {
+    signal_handler_add(handler, "void face_emotion_results(ptr source, ptr faces, int count, int timestamp_ns)");
+  }
 
-  if (face_model_path.empty() || emotion_model_path.empty()) {
+  // No other thread can see this filter yet, so the initial snapshot is
+  // assembled and published without the atomic accessors.
+  FilterConfig initial_config = *config_;
+  face_model_path_ = ResolveModelVariant(kFaceModelName, initial_config.model_precision);
+  emotion_model_path_ = ResolveModelVariant(kEmotionModelName, initial_config.model_precision);
+
+  char *cache_dir = obs_module_config_path("dnn-cache");
+  if (cache_dir != nullptr) {
+    os_mkdirs(cache_dir);
+    dnn_cache_dir_ = cache_dir;
+    bfree(cache_dir);
+  }
+  initial_config.dnn_cache_dir = dnn_cache_dir_;
+  config_ = std::make_shared<const FilterConfig>(initial_config);
+
+  if (face_model_path_.empty() || emotion_model_path_.empty()) {
     obs_log(LOG_ERROR, "unable to resolve model paths; filter will stay disabled");
     return;
   }
 
-  if (!std::filesystem::exists(face_model_path) || !std::filesystem::exists(emotion_model_path)) {
+  if (!std::filesystem::exists(face_model_path_) || !std::filesystem::exists(emotion_model_path_)) {
     obs_log(LOG_ERROR, "missing model file(s). expected under data/models/");
     return;
   }
 
+  if (InferenceService::Instance() == nullptr) {
+    obs_log(LOG_ERROR, "inference service is not loaded; filter will stay disabled");
+    return;
+  }
+
   std::string error;
-  if (!worker_.Start(face_model_path, emotion_model_path, BuildWorkerConfig(config_), &error)) {
-    obs_log(LOG_ERROR, "failed to start inference worker: %s", error.c_str());
+  worker_ = InferenceService::Instance()->AcquireWorker(
+    face_model_path_, emotion_model_path_, BuildWorkerConfig(initial_config), &error);
+  if (worker_ == nullptr) {
+    obs_log(LOG_ERROR, "failed to acquire inference worker: %s", error.c_str());
     return;
   }
 
+  client_id_ = worker_->RegisterClient(BuildWorkerConfig(initial_config));
   worker_ready_ = true;
 }
 
 FaceEmotionFilter::~FaceEmotionFilter()
 {
-  worker_.Stop();
+  ClearSyncRing();
+  if (worker_ != nullptr) {
+    worker_->UnregisterClient(client_id_);
+    worker_.reset();
+  }
+  ClearLabelTextures();
 }
 
 void FaceEmotionFilter::Update(obs_data_t *settings)
 {
   FilterConfig updated_config;
   updated_config.enabled = obs_data_get_bool(settings, kSettingEnabled);
-  updated_config.max_faces = std::clamp(static_cast<int>(obs_data_get_int(settings, kSettingMaxFaces)), 1, 3);
+  updated_config.max_faces = std::clamp(static_cast<int>(obs_data_get_int(settings, kSettingMaxFaces)), 1, 16);
   updated_config.inference_fps = std::clamp(static_cast<int>(obs_data_get_int(settings, kSettingInferenceFps)), 0, 240);
   updated_config.inference_width =
     std::clamp(static_cast<int>(obs_data_get_int(settings, kSettingInferenceWidth)), 160, 1920);
@@ -296,6 +506,27 @@ void FaceEmotionFilter::Update(obs_data_t *settings)
     std::clamp(static_cast<float>(obs_data_get_double(settings, kSettingConfidenceThreshold)), 0.0f, 1.0f);
   updated_config.smoothing_seconds =
     std::clamp(static_cast<float>(obs_data_get_double(settings, kSettingSmoothingSeconds)), 0.0f, 2.0f);
+  updated_config.motion_threshold =
+    std::clamp(static_cast<float>(obs_data_get_double(settings, kSettingMotionThreshold)), 0.0f, 20.0f);
+  updated_config.sync_mode = obs_data_get_bool(settings, kSettingSyncMode);
+  updated_config.sync_deadline_ms =
+    std::clamp(static_cast<int>(obs_data_get_int(settings, kSettingSyncDeadlineMs)), 10, 500);
+  updated_config.adaptive_width = obs_data_get_bool(settings, kSettingAdaptiveWidth);
+  updated_config.target_latency_ms =
+    std::clamp(static_cast<float>(obs_data_get_double(settings, kSettingTargetLatencyMs)), 5.0f, 200.0f);
+  updated_config.worker_low_priority = obs_data_get_bool(settings, kSettingWorkerLowPriority);
+  updated_config.fixed_detector_input = obs_data_get_bool(settings, kSettingFixedDetectorInput);
+  updated_config.roi_detection = obs_data_get_bool(settings, kSettingRoiDetection);
+  updated_config.full_sweep_interval_s =
+    std::clamp(static_cast<float>(obs_data_get_double(settings, kSettingFullSweepInterval)), 0.1f, 10.0f);
+  updated_config.opencv_threads = std::clamp(static_cast<int>(obs_data_get_int(settings, kSettingOpenCvThreads)), 0, 64);
+
+  // The affinity mask is entered as text so all 64 bits stay addressable;
+  // both hex ("0x0F") and decimal are accepted, and garbage parses to 0 (no
+  // pinning).
+  const char *affinity_text = obs_data_get_string(settings, kSettingWorkerAffinityMask);
+  updated_config.worker_affinity_mask =
+    affinity_text != nullptr ? std::strtoull(affinity_text, nullptr, 0) : 0;
   updated_config.show_confidence = obs_data_get_bool(settings, kSettingShowConfidence);
   updated_config.show_box = obs_data_get_bool(settings, kSettingShowBox);
   updated_config.box_use_emotion_color = obs_data_get_bool(settings, kSettingBoxUseEmotionColor);
@@ -305,6 +536,9 @@ void FaceEmotionFilter::Update(obs_data_t *settings)
   updated_config.box_thickness = std::clamp(static_cast<int>(obs_data_get_int(settings, kSettingBoxThickness)), 1, 12);
   updated_config.show_label = obs_data_get_bool(settings, kSettingShowLabel);
   updated_config.show_track_id = obs_data_get_bool(settings, kSettingShowTrackId);
+
+  const char *render_mode = obs_data_get_string(settings, kSettingRenderMode);
+  updated_config.gpu_overlay = render_mode != nullptr && std::strcmp(render_mode, kRenderModeGpu) == 0;
   updated_config.text_use_emotion_color = obs_data_get_bool(settings, kSettingTextUseEmotionColor);
   updated_config.text_color_r = std::clamp(static_cast<int>(obs_data_get_int(settings, kSettingTextColorR)), 0, 255);
   updated_config.text_color_g = std::clamp(static_cast<int>(obs_data_get_int(settings, kSettingTextColorG)), 0, 255);
@@ -318,14 +552,48 @@ void FaceEmotionFilter::Update(obs_data_t *settings)
 
   const char *low_conf_label = obs_data_get_string(settings, kSettingLowConfidenceLabel);
   updated_config.low_conf_label = low_conf_label != nullptr && low_conf_label[0] != '\0' ? low_conf_label : "Incertain";
-
-  {
-    std::scoped_lock lock(config_mutex_);
-    config_ = updated_config;
+  updated_config.dnn_backend = ParseDnnBackend(obs_data_get_string(settings, kSettingDnnBackend));
+  updated_config.dnn_cache_dir = dnn_cache_dir_;
+
+  const char *model_precision = obs_data_get_string(settings, kSettingModelPrecision);
+  if (model_precision != nullptr &&
+      (std::strcmp(model_precision, kModelPrecisionFp16) == 0 ||
+       std::strcmp(model_precision, kModelPrecisionInt8) == 0)) {
+    updated_config.model_precision = model_precision;
   }
 
-  if (worker_ready_) {
-    worker_.UpdateConfig(BuildWorkerConfig(updated_config));
+  // Publish the new settings as an immutable snapshot; in-flight readers keep
+  // the snapshot they loaded until their frame is done.
+  const std::shared_ptr<const FilterConfig> previous = std::atomic_load(&config_);
+  const bool needs_restart = previous->dnn_backend != updated_config.dnn_backend ||
+                             previous->model_precision != updated_config.model_precision ||
+                             previous->worker_low_priority != updated_config.worker_low_priority ||
+                             previous->worker_affinity_mask != updated_config.worker_affinity_mask ||
+                             previous->opencv_threads != updated_config.opencv_threads ||
+                             previous->fixed_detector_input != updated_config.fixed_detector_input;
+  std::atomic_store(&config_, std::make_shared<const FilterConfig>(updated_config));
+
+  if (worker_ready_ && needs_restart) {
+    // Backend and model selection are bound when the networks are created, so
+    // a change restarts the worker (Start stops the previous thread first).
+    face_model_path_ = ResolveModelVariant(kFaceModelName, updated_config.model_precision);
+    emotion_model_path_ = ResolveModelVariant(kEmotionModelName, updated_config.model_precision);
+
+    worker_->UnregisterClient(client_id_);
+    worker_.reset();
+    worker_ready_ = false;
+
+    std::string error;
+    worker_ = InferenceService::Instance()->AcquireWorker(
+      face_model_path_, emotion_model_path_, BuildWorkerConfig(updated_config), &error);
+    if (worker_ == nullptr) {
+      obs_log(LOG_ERROR, "failed to restart inference worker: %s", error.c_str());
+      return;
+    }
+    client_id_ = worker_->RegisterClient(BuildWorkerConfig(updated_config));
+    worker_ready_ = true;
+  } else if (worker_ready_) {
+    worker_->UpdateClientConfig(client_id_, BuildWorkerConfig(updated_config));
   }
 }
 
@@ -339,13 +607,13 @@ obs_source_frame *FaceEmotionFilter::FilterVideo(obs_source_frame *frame)
     return frame;
   }
 
-  FilterConfig local_config;
-  {
-    std::scoped_lock lock(config_mutex_);
-    local_config = config_;
-  }
+  // Wait-free settings read: the snapshot stays alive for the whole frame
+  // even if Update publishes a new one mid-flight.
+  const std::shared_ptr<const FilterConfig> config_snapshot = std::atomic_load(&config_);
+  const FilterConfig &local_config = *config_snapshot;
 
   if (!local_config.enabled) {
+    ClearSyncRing();
     return frame;
   }
 
@@ -368,49 +636,157 @@ obs_source_frame *FaceEmotionFilter::FilterVideo(obs_source_frame *frame)
   const bool unthrottled = configured_fps == 0;
   const uint64_t interval_ns = unthrottled ? 0 : (kOneSecondNs / static_cast<uint64_t>(configured_fps));
 
-  cv::Mat current_bgr_frame;
-  bool have_current_bgr = false;
-
-  if (unthrottled || last_submitted_ts_ns_ == 0 || timestamp_ns >= last_submitted_ts_ns_ + interval_ns) {
-    if (ExtractBgrFrame(frame, &current_bgr_frame)) {
-      worker_.SubmitFrame(
-        current_bgr_frame,
+  if (
+    worker_->IsReady() &&
+    (unthrottled || last_submitted_ts_ns_ == 0 || timestamp_ns >= last_submitted_ts_ns_ + interval_ns) &&
+    (local_config.motion_threshold <= 0.0f || DetectMotion(frame, local_config.motion_threshold))) {
+    // Convert and downscale in one pass so the submit path never materializes
+    // a full-resolution BGR frame. With the adaptive controller on, extract at
+    // the width it currently holds so the worker never has to resize again.
+    int extract_width = local_config.inference_width;
+    if (local_config.adaptive_width) {
+      const int effective_width = worker_->EffectiveInferenceWidth(client_id_);
+      if (effective_width > 0) {
+        extract_width = std::min(effective_width, local_config.inference_width);
+      }
+    }
+    // Both networks only ever consume luma, so planar and packed YUV sources
+    // submit the Y plane directly and skip the chroma math entirely; packed
+    // RGB formats still go through the fused BGR conversion.
+    cv::Mat inference_frame;
+    const auto extract_started = std::chrono::steady_clock::now();
+    const bool extracted = ExtractGrayFrame(frame, &inference_frame, extract_width) ||
+                           ExtractBgrFrame(frame, &inference_frame, extract_width);
+    stage_stats_.extract.Record(MillisecondsSince(extract_started));
+    if (extracted) {
+      worker_->SubmitFrame(
+        client_id_,
+        inference_frame,
         timestamp_ns,
         static_cast<int>(frame->width),
         static_cast<int>(frame->height));
       if (!unthrottled) {
         last_submitted_ts_ns_ = timestamp_ns;
       }
-      have_current_bgr = true;
     }
   }
 
   std::vector<DetectedFace> faces;
-  double inference_ms = 0.0;
-  if (worker_.TryConsumeLatest(&faces, &inference_ms, nullptr)) {
+  uint64_t result_timestamp_ns = 0;
+  if (worker_->TryConsumeLatest(client_id_, &faces, nullptr, &result_timestamp_ns)) {
     latest_faces_ = std::move(faces);
-    perf_total_ms_ += inference_ms;
-    perf_samples_++;
+    latest_result_ts_ns_ = result_timestamp_ns;
     perf_results_++;
+    EmitResultsSignal(latest_faces_, result_timestamp_ns);
   }
 
-  if (local_config.show_box || local_config.show_label) {
-    if (SupportsInPlaceOverlay(frame->format)) {
-      DrawOverlay(frame, latest_faces_, local_config);
-    } else {
-      if (!have_current_bgr) {
-        have_current_bgr = ExtractBgrFrame(frame, &current_bgr_frame);
-      }
+  if (!local_config.show_box && !local_config.show_label) {
+    // Data-tap mode: the signal above is the output, so no prediction,
+    // overlay snapshot or pixel work happens at all.
+    ClearSyncRing();
+    LogPerfEveryFiveSeconds(timestamp_ns);
+    return frame;
+  }
 
-      if (have_current_bgr) {
-        DrawOverlayOnBgr(&current_bgr_frame, latest_faces_, local_config);
-        WriteBgrFrame(frame, current_bgr_frame);
+  // Sync mode holds frames until their result catches up, so the overlay is
+  // drawn onto the very frame it was computed from; everything below operates
+  // on whichever frame comes back out of the ring.
+  obs_source_frame *output_frame = frame;
+  if (local_config.sync_mode) {
+    output_frame = SyncModeExchangeFrame(frame, local_config);
+    if (output_frame == nullptr) {
+      LogPerfEveryFiveSeconds(timestamp_ns);
+      return nullptr;
+    }
+  } else {
+    ClearSyncRing();
+  }
+  const uint64_t display_ts_ns = output_frame == frame ? timestamp_ns : GetTimestampNs(output_frame);
+
+  // Coast the overlay between results: boxes move along their track velocity
+  // every frame, so a low inference rate no longer shows as lag and jumps.
+  // With a matching sync-mode result the prediction step is zero.
+  std::vector<DetectedFace> display_faces = latest_faces_;
+  PredictFaces(&display_faces, display_ts_ns, static_cast<int>(output_frame->width), static_cast<int>(output_frame->height));
+
+  {
+    std::scoped_lock overlay_lock(overlay_mutex_);
+    overlay_faces_ = display_faces;
+  }
+
+  if (local_config.gpu_overlay) {
+    // The overlay is composited in RenderOverlay on the graphics thread; no
+    // pixel mutation (and thus no BGR round-trip) happens here.
+    LogPerfEveryFiveSeconds(timestamp_ns);
+    return output_frame;
+  }
+
+  if (local_config.show_box || local_config.show_label) {
+    if (SupportsInPlaceOverlay(output_frame->format)) {
+      const auto overlay_started = std::chrono::steady_clock::now();
+      DrawOverlay(output_frame, display_faces, local_config);
+      stage_stats_.overlay.Record(MillisecondsSince(overlay_started));
+    } else if (!display_faces.empty()) {
+      // Only the overlay path needs the full-resolution BGR frame, and only
+      // the regions the overlay touched are converted back, so write-back cost
+      // scales with face count instead of frame area.
+      const auto overlay_started = std::chrono::steady_clock::now();
+      cv::Mat overlay_bgr_frame;
+      if (ExtractBgrFrame(output_frame, &overlay_bgr_frame)) {
+        std::vector<cv::Rect> dirty_rects;
+        DrawOverlayOnBgr(&overlay_bgr_frame, display_faces, local_config, &dirty_rects);
+        stage_stats_.overlay.Record(MillisecondsSince(overlay_started));
+        if (!dirty_rects.empty()) {
+          const auto write_back_started = std::chrono::steady_clock::now();
+          WriteBgrFrame(output_frame, overlay_bgr_frame, &dirty_rects);
+          stage_stats_.write_back.Record(MillisecondsSince(write_back_started));
+        }
       }
     }
   }
 
   LogPerfEveryFiveSeconds(timestamp_ns);
-  return frame;
+  return output_frame;
+}
+
+obs_source_frame *FaceEmotionFilter::SyncModeExchangeFrame(obs_source_frame *frame, const FilterConfig &config)
+{
+  sync_ring_.push_back({frame, std::chrono::steady_clock::now()});
+
+  // Drop (not emit) everything past capacity so a stalled worker can never
+  // pin unbounded frame memory.
+  obs_source_t *parent = obs_filter_get_parent(source_);
+  while (sync_ring_.size() > kSyncRingCapacity) {
+    obs_source_release_frame(parent, sync_ring_.front().frame);
+    sync_ring_.pop_front();
+  }
+
+  // The oldest frame comes out once a result at (or past) its timestamp
+  // exists; the deadline falls back to the async behavior, a stale overlay
+  // rather than a frozen feed.
+  PendingSyncFrame &front = sync_ring_.front();
+  const bool result_arrived = latest_result_ts_ns_ != 0 && latest_result_ts_ns_ >= GetTimestampNs(front.frame);
+  const bool deadline_passed = MillisecondsSince(front.enqueued_at) >= static_cast<double>(config.sync_deadline_ms);
+  if (!result_arrived && !deadline_passed) {
+    return nullptr;
+  }
+
+  obs_source_frame *released = front.frame;
+  sync_ring_.pop_front();
+  return released;
+}
+
+void FaceEmotionFilter::ClearSyncRing()
+{
+  if (sync_ring_.empty()) {
+    return;
+  }
+
+  obs_source_t *parent = obs_filter_get_parent(source_);
+  for (PendingSyncFrame &pending : sync_ring_) {
+    obs_source_release_frame(parent, pending.frame);
+  }
+  sync_ring_.clear();
 }
 
 void FaceEmotionFilter::GetDefaults(obs_data_t *settings)
@@ -421,6 +797,19 @@ void FaceEmotionFilter::GetDefaults(obs_data_t *settings)
   obs_data_set_default_int(settings, kSettingInferenceWidth, 640);
   obs_data_set_default_double(settings, kSettingConfidenceThreshold, 0.30);
   obs_data_set_default_double(settings, kSettingSmoothingSeconds, 0.6);
+  obs_data_set_default_double(settings, kSettingMotionThreshold, 0.0);
+  obs_data_set_default_bool(settings, kSettingSyncMode, false);
+  obs_data_set_default_int(settings, kSettingSyncDeadlineMs, 50);
+  obs_data_set_default_bool(settings, kSettingAdaptiveWidth, false);
+  obs_data_set_default_double(settings, kSettingTargetLatencyMs, 33.0);
+  obs_data_set_default_bool(settings, kSettingWorkerLowPriority, false);
+  obs_data_set_default_bool(settings, kSettingFixedDetectorInput, false);
+  obs_data_set_default_bool(settings, kSettingRoiDetection, false);
+  obs_data_set_default_double(settings, kSettingFullSweepInterval, 1.0);
+  obs_data_set_default_string(settings, kSettingWorkerAffinityMask, "");
+  obs_data_set_default_int(settings, kSettingOpenCvThreads, 0);
+  obs_data_set_default_string(settings, kSettingDnnBackend, kDnnBackendAuto);
+  obs_data_set_default_string(settings, kSettingModelPrecision, kModelPrecisionFp32);
   obs_data_set_default_bool(settings, kSettingShowConfidence, true);
   obs_data_set_default_bool(settings, kSettingShowBox, true);
   obs_data_set_default_bool(settings, kSettingBoxUseEmotionColor, true);
@@ -430,6 +819,7 @@ void FaceEmotionFilter::GetDefaults(obs_data_t *settings)
   obs_data_set_default_int(settings, kSettingBoxThickness, 2);
   obs_data_set_default_bool(settings, kSettingShowLabel, true);
   obs_data_set_default_bool(settings, kSettingShowTrackId, false);
+  obs_data_set_default_string(settings, kSettingRenderMode, kRenderModeCpu);
   obs_data_set_default_bool(settings, kSettingTextUseEmotionColor, true);
   obs_data_set_default_int(settings, kSettingTextColorR, 255);
   obs_data_set_default_int(settings, kSettingTextColorG, 255);
@@ -446,7 +836,7 @@ obs_properties_t *FaceEmotionFilter::GetProperties()
 {
   obs_properties_t *props = obs_properties_create();
   obs_properties_add_bool(props, kSettingEnabled, obs_module_text("FaceEmotionFilter.Enabled"));
-  obs_properties_add_int_slider(props, kSettingMaxFaces, obs_module_text("FaceEmotionFilter.MaxFaces"), 1, 3, 1);
+  obs_properties_add_int_slider(props, kSettingMaxFaces, obs_module_text("FaceEmotionFilter.MaxFaces"), 1, 16, 1);
   obs_properties_add_int_slider(props, kSettingInferenceFps, obs_module_text("FaceEmotionFilter.InferenceFps"), 0, 240, 1);
   obs_properties_add_int_slider(
     props,
@@ -469,6 +859,76 @@ obs_properties_t *FaceEmotionFilter::GetProperties()
     0.0,
     2.0,
     0.1);
+  obs_properties_add_float_slider(
+    props,
+    kSettingMotionThreshold,
+    obs_module_text("FaceEmotionFilter.MotionThreshold"),
+    0.0,
+    20.0,
+    0.1);
+  obs_properties_add_bool(props, kSettingSyncMode, obs_module_text("FaceEmotionFilter.SyncMode"));
+  obs_properties_add_int_slider(
+    props,
+    kSettingSyncDeadlineMs,
+    obs_module_text("FaceEmotionFilter.SyncDeadlineMs"),
+    10,
+    500,
+    5);
+  obs_properties_add_bool(props, kSettingAdaptiveWidth, obs_module_text("FaceEmotionFilter.AdaptiveWidth"));
+  obs_properties_add_float_slider(
+    props,
+    kSettingTargetLatencyMs,
+    obs_module_text("FaceEmotionFilter.TargetLatencyMs"),
+    5.0,
+    200.0,
+    1.0);
+  obs_properties_add_bool(
+    props, kSettingFixedDetectorInput, obs_module_text("FaceEmotionFilter.FixedDetectorInput"));
+  obs_properties_add_bool(props, kSettingRoiDetection, obs_module_text("FaceEmotionFilter.RoiDetection"));
+  obs_properties_add_float_slider(
+    props,
+    kSettingFullSweepInterval,
+    obs_module_text("FaceEmotionFilter.FullSweepInterval"),
+    0.1,
+    10.0,
+    0.1);
+  obs_properties_add_bool(props, kSettingWorkerLowPriority, obs_module_text("FaceEmotionFilter.WorkerLowPriority"));
+  obs_properties_add_text(
+    props,
+    kSettingWorkerAffinityMask,
+    obs_module_text("FaceEmotionFilter.WorkerAffinityMask"),
+    OBS_TEXT_DEFAULT);
+  obs_properties_add_int_slider(
+    props,
+    kSettingOpenCvThreads,
+    obs_module_text("FaceEmotionFilter.OpenCvThreads"),
+    0,
+    64,
+    1);
+  obs_property_t *dnn_backend = obs_properties_add_list(
+    props,
+    kSettingDnnBackend,
+    obs_module_text("FaceEmotionFilter.DnnBackend"),
+    OBS_COMBO_TYPE_LIST,
+    OBS_COMBO_FORMAT_STRING);
+  obs_property_list_add_string(dnn_backend, obs_module_text("FaceEmotionFilter.DnnBackendAuto"), kDnnBackendAuto);
+  obs_property_list_add_string(dnn_backend, obs_module_text("FaceEmotionFilter.DnnBackendCpu"), kDnnBackendCpu);
+  obs_property_list_add_string(dnn_backend, obs_module_text("FaceEmotionFilter.DnnBackendOpenCl"), kDnnBackendOpenCl);
+  obs_property_list_add_string(
+    dnn_backend, obs_module_text("FaceEmotionFilter.DnnBackendOpenClFp16"), kDnnBackendOpenClFp16);
+  obs_property_list_add_string(dnn_backend, obs_module_text("FaceEmotionFilter.DnnBackendCuda"), kDnnBackendCuda);
+  obs_property_t *model_precision = obs_properties_add_list(
+    props,
+    kSettingModelPrecision,
+    obs_module_text("FaceEmotionFilter.ModelPrecision"),
+    OBS_COMBO_TYPE_LIST,
+    OBS_COMBO_FORMAT_STRING);
+  obs_property_list_add_string(
+    model_precision, obs_module_text("FaceEmotionFilter.ModelPrecisionFp32"), kModelPrecisionFp32);
+  obs_property_list_add_string(
+    model_precision, obs_module_text("FaceEmotionFilter.ModelPrecisionFp16"), kModelPrecisionFp16);
+  obs_property_list_add_string(
+    model_precision, obs_module_text("FaceEmotionFilter.ModelPrecisionInt8"), kModelPrecisionInt8);
   obs_properties_add_bool(props, kSettingShowBox, obs_module_text("FaceEmotionFilter.ShowBox"));
   obs_properties_add_bool(
     props,
@@ -486,6 +946,14 @@ obs_properties_t *FaceEmotionFilter::GetProperties()
     1);
   obs_properties_add_bool(props, kSettingShowLabel, obs_module_text("FaceEmotionFilter.ShowLabel"));
   obs_properties_add_bool(props, kSettingShowTrackId, obs_module_text("FaceEmotionFilter.ShowTrackId"));
+  obs_property_t *render_mode = obs_properties_add_list(
+    props,
+    kSettingRenderMode,
+    obs_module_text("FaceEmotionFilter.RenderMode"),
+    OBS_COMBO_TYPE_LIST,
+    OBS_COMBO_FORMAT_STRING);
+  obs_property_list_add_string(render_mode, obs_module_text("FaceEmotionFilter.RenderModeCpu"), kRenderModeCpu);
+  obs_property_list_add_string(render_mode, obs_module_text("FaceEmotionFilter.RenderModeGpu"), kRenderModeGpu);
   obs_properties_add_bool(
     props,
     kSettingTextUseEmotionColor,
@@ -528,7 +996,7 @@ uint64_t FaceEmotionFilter::GetTimestampNs(const obs_source_frame *frame)
   return os_gettime_ns();
 }
 
-bool FaceEmotionFilter::ExtractBgrFrame(const obs_source_frame *frame, cv::Mat *bgr_frame) const
+bool FaceEmotionFilter::ExtractBgrFrame(const obs_source_frame *frame, cv::Mat *bgr_frame, const int target_width) const
 {
   if (frame == nullptr || bgr_frame == nullptr || frame->data[0] == nullptr || frame->width == 0 || frame->height == 0) {
     return false;
@@ -536,6 +1004,8 @@ bool FaceEmotionFilter::ExtractBgrFrame(const obs_source_frame *frame, cv::Mat *
 
   const int width = static_cast<int>(frame->width);
   const int height = static_cast<int>(frame->height);
+  const cv::Size target = ComputeTargetSize(width, height, target_width);
+  const bool scaled = target.width != width || target.height != height;
 
   switch (frame->format) {
   case VIDEO_FORMAT_BGRA:
@@ -546,7 +1016,14 @@ bool FaceEmotionFilter::ExtractBgrFrame(const obs_source_frame *frame, cv::Mat *
     const int code = (frame->format == VIDEO_FORMAT_BGRA || frame->format == VIDEO_FORMAT_BGRX)
       ? cv::COLOR_BGRA2BGR
       : cv::COLOR_RGBA2BGR;
-    cv::cvtColor(rgba_mat, *bgr_frame, code);
+    if (scaled) {
+      // Downscale the packed source first so the conversion only touches target-size pixels.
+      cv::Mat rgba_small;
+      cv::resize(rgba_mat, rgba_small, target, 0.0, 0.0, cv::INTER_LINEAR);
+      cv::cvtColor(rgba_small, *bgr_frame, code);
+    } else {
+      cv::cvtColor(rgba_mat, *bgr_frame, code);
+    }
     return true;
   }
   case VIDEO_FORMAT_NV12: {
@@ -555,7 +1032,17 @@ bool FaceEmotionFilter::ExtractBgrFrame(const obs_source_frame *frame, cv::Mat *
     }
     cv::Mat y_plane(height, width, CV_8UC1, frame->data[0], static_cast<std::size_t>(frame->linesize[0]));
     cv::Mat uv_plane(height / 2, width / 2, CV_8UC2, frame->data[1], static_cast<std::size_t>(frame->linesize[1]));
-    cv::cvtColorTwoPlane(y_plane, uv_plane, *bgr_frame, cv::COLOR_YUV2BGR_NV12);
+    if (scaled) {
+      // Scale the subsampled planes independently; the color conversion then
+      // runs entirely at inference resolution.
+      cv::Mat y_small;
+      cv::Mat uv_small;
+      cv::resize(y_plane, y_small, target, 0.0, 0.0, cv::INTER_LINEAR);
+      cv::resize(uv_plane, uv_small, cv::Size(target.width / 2, target.height / 2), 0.0, 0.0, cv::INTER_LINEAR);
+      cv::cvtColorTwoPlane(y_small, uv_small, *bgr_frame, cv::COLOR_YUV2BGR_NV12);
+    } else {
+      cv::cvtColorTwoPlane(y_plane, uv_plane, *bgr_frame, cv::COLOR_YUV2BGR_NV12);
+    }
     return true;
   }
   case VIDEO_FORMAT_I420: {
@@ -563,56 +1050,136 @@ bool FaceEmotionFilter::ExtractBgrFrame(const obs_source_frame *frame, cv::Mat *
       return false;
     }
 
-    cv::Mat i420(height * 3 / 2, width, CV_8UC1);
-    uint8_t *dst = i420.data;
-    if (!CopyPlaneToLinear(
-          frame->data[0],
-          static_cast<std::size_t>(frame->linesize[0]),
-          dst,
-          static_cast<std::size_t>(width),
-          height)) {
-      return false;
-    }
-
     const int chroma_width = width / 2;
     const int chroma_height = height / 2;
-    uint8_t *u_dst = dst + static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
-    uint8_t *v_dst = u_dst + static_cast<std::size_t>(chroma_width) * static_cast<std::size_t>(chroma_height);
-
-    if (!CopyPlaneToLinear(
-          frame->data[1],
-          static_cast<std::size_t>(frame->linesize[1]),
-          u_dst,
-          static_cast<std::size_t>(chroma_width),
-          chroma_height)) {
+    cv::Mat y_plane(height, width, CV_8UC1, frame->data[0], static_cast<std::size_t>(frame->linesize[0]));
+    cv::Mat u_plane(chroma_height, chroma_width, CV_8UC1, frame->data[1], static_cast<std::size_t>(frame->linesize[1]));
+    cv::Mat v_plane(chroma_height, chroma_width, CV_8UC1, frame->data[2], static_cast<std::size_t>(frame->linesize[2]));
+
+    bgr_frame->create(target.height, target.width, CV_8UC3);
+    if (scaled) {
+      // Scale the planes first, then convert directly from the compact planes;
+      // no linear I420 staging buffer is needed in either case.
+      cv::Mat y_small;
+      cv::Mat u_small;
+      cv::Mat v_small;
+      cv::resize(y_plane, y_small, target, 0.0, 0.0, cv::INTER_LINEAR);
+      cv::resize(u_plane, u_small, cv::Size(target.width / 2, target.height / 2), 0.0, 0.0, cv::INTER_LINEAR);
+      cv::resize(v_plane, v_small, cv::Size(target.width / 2, target.height / 2), 0.0, 0.0, cv::INTER_LINEAR);
+      yuv_convert::I420ToBgr(
+        y_small.data,
+        y_small.step,
+        u_small.data,
+        u_small.step,
+        v_small.data,
+        v_small.step,
+        bgr_frame->data,
+        bgr_frame->step,
+        target.width,
+        target.height);
+    } else {
+      yuv_convert::I420ToBgr(
+        frame->data[0],
+        static_cast<std::size_t>(frame->linesize[0]),
+        frame->data[1],
+        static_cast<std::size_t>(frame->linesize[1]),
+        frame->data[2],
+        static_cast<std::size_t>(frame->linesize[2]),
+        bgr_frame->data,
+        bgr_frame->step,
+        width,
+        height);
+    }
+    return true;
+  }
+  case VIDEO_FORMAT_P010: {
+    if (frame->data[1] == nullptr) {
       return false;
     }
 
-    if (!CopyPlaneToLinear(
-          frame->data[2],
-          static_cast<std::size_t>(frame->linesize[2]),
-          v_dst,
-          static_cast<std::size_t>(chroma_width),
-          chroma_height)) {
+    // 16-bit NV12: scale the 10-bit planes first when shrinking, narrow to 8
+    // bits with the SIMD kernel, then reuse the NV12 conversion.
+    cv::Mat y16(height, width, CV_16UC1, frame->data[0], static_cast<std::size_t>(frame->linesize[0]));
+    cv::Mat uv16(height / 2, width / 2, CV_16UC2, frame->data[1], static_cast<std::size_t>(frame->linesize[1]));
+    if (scaled) {
+      cv::Mat y16_small;
+      cv::Mat uv16_small;
+      cv::resize(y16, y16_small, target, 0.0, 0.0, cv::INTER_LINEAR);
+      cv::resize(uv16, uv16_small, cv::Size(target.width / 2, target.height / 2), 0.0, 0.0, cv::INTER_LINEAR);
+      y16 = y16_small;
+      uv16 = uv16_small;
+    }
+
+    cv::Mat y8(y16.rows, y16.cols, CV_8UC1);
+    cv::Mat uv8(uv16.rows, uv16.cols, CV_8UC2);
+    yuv_convert::Narrow10To8(y16.ptr<uint16_t>(), y16.step, y8.data, y8.step, y16.cols, y16.rows, 8);
+    yuv_convert::Narrow10To8(uv16.ptr<uint16_t>(), uv16.step, uv8.data, uv8.step, uv16.cols * 2, uv16.rows, 8);
+    cv::cvtColorTwoPlane(y8, uv8, *bgr_frame, cv::COLOR_YUV2BGR_NV12);
+    return true;
+  }
+  case VIDEO_FORMAT_I010: {
+    if (frame->data[1] == nullptr || frame->data[2] == nullptr) {
       return false;
     }
 
-    cv::cvtColor(i420, *bgr_frame, cv::COLOR_YUV2BGR_I420);
+    // 16-bit I420 with low-aligned samples; same plane-wise narrowing as
+    // P010 but with a 2-bit shift, feeding the strided I420 kernel.
+    const int chroma_width = width / 2;
+    const int chroma_height = height / 2;
+    cv::Mat y16(height, width, CV_16UC1, frame->data[0], static_cast<std::size_t>(frame->linesize[0]));
+    cv::Mat u16(chroma_height, chroma_width, CV_16UC1, frame->data[1], static_cast<std::size_t>(frame->linesize[1]));
+    cv::Mat v16(chroma_height, chroma_width, CV_16UC1, frame->data[2], static_cast<std::size_t>(frame->linesize[2]));
+    if (scaled) {
+      cv::Mat y16_small;
+      cv::Mat u16_small;
+      cv::Mat v16_small;
+      cv::resize(y16, y16_small, target, 0.0, 0.0, cv::INTER_LINEAR);
+      cv::resize(u16, u16_small, cv::Size(target.width / 2, target.height / 2), 0.0, 0.0, cv::INTER_LINEAR);
+      cv::resize(v16, v16_small, cv::Size(target.width / 2, target.height / 2), 0.0, 0.0, cv::INTER_LINEAR);
+      y16 = y16_small;
+      u16 = u16_small;
+      v16 = v16_small;
+    }
+
+    cv::Mat y8(y16.rows, y16.cols, CV_8UC1);
+    cv::Mat u8(u16.rows, u16.cols, CV_8UC1);
+    cv::Mat v8(v16.rows, v16.cols, CV_8UC1);
+    yuv_convert::Narrow10To8(y16.ptr<uint16_t>(), y16.step, y8.data, y8.step, y16.cols, y16.rows, 2);
+    yuv_convert::Narrow10To8(u16.ptr<uint16_t>(), u16.step, u8.data, u8.step, u16.cols, u16.rows, 2);
+    yuv_convert::Narrow10To8(v16.ptr<uint16_t>(), v16.step, v8.data, v8.step, v16.cols, v16.rows, 2);
+
+    bgr_frame->create(y8.rows, y8.cols, CV_8UC3);
+    yuv_convert::I420ToBgr(
+      y8.data, y8.step, u8.data, u8.step, v8.data, v8.step, bgr_frame->data, bgr_frame->step, y8.cols, y8.rows);
     return true;
   }
   case VIDEO_FORMAT_YUY2: {
     cv::Mat yuy2(height, width, CV_8UC2, frame->data[0], static_cast<std::size_t>(frame->linesize[0]));
+    // Packed 4:2:2 cannot be scaled before conversion without corrupting the
+    // chroma siting, so convert first and downscale the BGR result.
     cv::cvtColor(yuy2, *bgr_frame, cv::COLOR_YUV2BGR_YUY2);
+    if (scaled) {
+      cv::resize(*bgr_frame, *bgr_frame, target, 0.0, 0.0, cv::INTER_LINEAR);
+    }
     return true;
   }
   case VIDEO_FORMAT_UYVY: {
     cv::Mat uyvy(height, width, CV_8UC2, frame->data[0], static_cast<std::size_t>(frame->linesize[0]));
     cv::cvtColor(uyvy, *bgr_frame, cv::COLOR_YUV2BGR_UYVY);
+    if (scaled) {
+      cv::resize(*bgr_frame, *bgr_frame, target, 0.0, 0.0, cv::INTER_LINEAR);
+    }
     return true;
   }
   case VIDEO_FORMAT_Y800: {
     cv::Mat gray(height, width, CV_8UC1, frame->data[0], static_cast<std::size_t>(frame->linesize[0]));
-    cv::cvtColor(gray, *bgr_frame, cv::COLOR_GRAY2BGR);
+    if (scaled) {
+      cv::Mat gray_small;
+      cv::resize(gray, gray_small, target, 0.0, 0.0, cv::INTER_LINEAR);
+      cv::cvtColor(gray_small, *bgr_frame, cv::COLOR_GRAY2BGR);
+    } else {
+      cv::cvtColor(gray, *bgr_frame, cv::COLOR_GRAY2BGR);
+    }
     return true;
   }
   default:
@@ -620,7 +1187,70 @@ bool FaceEmotionFilter::ExtractBgrFrame(const obs_source_frame *frame, cv::Mat *
   }
 }
 
-bool FaceEmotionFilter::WriteBgrFrame(obs_source_frame *frame, const cv::Mat &bgr_frame) const
+bool FaceEmotionFilter::ExtractGrayFrame(const obs_source_frame *frame, cv::Mat *gray_frame, const int target_width)
+{
+  if (frame == nullptr || gray_frame == nullptr || frame->data[0] == nullptr || frame->width == 0 ||
+      frame->height == 0) {
+    return false;
+  }
+
+  const int width = static_cast<int>(frame->width);
+  const int height = static_cast<int>(frame->height);
+  const cv::Size target = ComputeTargetSize(width, height, target_width);
+  const bool scaled = target.width != width || target.height != height;
+
+  switch (frame->format) {
+  case VIDEO_FORMAT_NV12:
+  case VIDEO_FORMAT_I420:
+  case VIDEO_FORMAT_Y800: {
+    // Zero-copy view over the Y plane; the only copy is the downscale (or the
+    // clone when the frame is already at inference size). The chroma planes
+    // are never touched.
+    cv::Mat y_plane(height, width, CV_8UC1, frame->data[0], static_cast<std::size_t>(frame->linesize[0]));
+    if (scaled) {
+      cv::resize(y_plane, *gray_frame, target, 0.0, 0.0, cv::INTER_LINEAR);
+    } else {
+      y_plane.copyTo(*gray_frame);
+    }
+    return true;
+  }
+  case VIDEO_FORMAT_P010:
+  case VIDEO_FORMAT_I010: {
+    // 10-bit sources resize the 16-bit Y plane first when scaling, so the
+    // SIMD narrowing only ever touches inference-size samples.
+    const int shift = frame->format == VIDEO_FORMAT_P010 ? 8 : 2;
+    cv::Mat y16(height, width, CV_16UC1, frame->data[0], static_cast<std::size_t>(frame->linesize[0]));
+    cv::Mat y16_small;
+    if (scaled) {
+      cv::resize(y16, y16_small, target, 0.0, 0.0, cv::INTER_LINEAR);
+      y16 = y16_small;
+    }
+    gray_frame->create(y16.rows, y16.cols, CV_8UC1);
+    yuv_convert::Narrow10To8(
+      y16.ptr<uint16_t>(), y16.step, gray_frame->data, gray_frame->step, y16.cols, y16.rows, shift);
+    return true;
+  }
+  case VIDEO_FORMAT_YUY2:
+  case VIDEO_FORMAT_UYVY: {
+    // Luma is interleaved with chroma, so this is one channel extraction
+    // rather than zero-copy, but still far cheaper than the 4:2:2 color
+    // conversion it replaces.
+    cv::Mat packed(height, width, CV_8UC2, frame->data[0], static_cast<std::size_t>(frame->linesize[0]));
+    cv::extractChannel(packed, *gray_frame, frame->format == VIDEO_FORMAT_YUY2 ? 0 : 1);
+    if (scaled) {
+      cv::resize(*gray_frame, *gray_frame, target, 0.0, 0.0, cv::INTER_LINEAR);
+    }
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+bool FaceEmotionFilter::WriteBgrFrame(
+  obs_source_frame *frame,
+  const cv::Mat &bgr_frame,
+  const std::vector<cv::Rect> *dirty_rects) const
 {
   if (frame == nullptr || frame->data[0] == nullptr || bgr_frame.empty()) {
     return false;
@@ -632,106 +1262,139 @@ bool FaceEmotionFilter::WriteBgrFrame(obs_source_frame *frame, const cv::Mat &bg
     return false;
   }
 
+  if (dirty_rects == nullptr) {
+    return WriteBgrRegion(frame, bgr_frame, cv::Rect(0, 0, width, height));
+  }
+
+  bool wrote_any = false;
+  for (const cv::Rect &rect : *dirty_rects) {
+    const cv::Rect aligned = AlignRectToEven(rect, width, height);
+    if (aligned.empty()) {
+      continue;
+    }
+    wrote_any = WriteBgrRegion(frame, bgr_frame, aligned) || wrote_any;
+  }
+  return wrote_any;
+}
+
+bool FaceEmotionFilter::WriteBgrRegion(obs_source_frame *frame, const cv::Mat &bgr_frame, const cv::Rect &rect)
+{
+  const std::size_t stride0 = static_cast<std::size_t>(frame->linesize[0]);
+  const std::size_t x = static_cast<std::size_t>(rect.x);
+  const std::size_t y = static_cast<std::size_t>(rect.y);
+
   switch (frame->format) {
   case VIDEO_FORMAT_BGRA:
   case VIDEO_FORMAT_BGRX:
   case VIDEO_FORMAT_RGBA:
   {
-    cv::Mat dst_rgba(height, width, CV_8UC4, frame->data[0], static_cast<std::size_t>(frame->linesize[0]));
+    const cv::Mat src = bgr_frame(rect);
+    cv::Mat dst_rgba(rect.height, rect.width, CV_8UC4, frame->data[0] + y * stride0 + 4 * x, stride0);
     const int code = (frame->format == VIDEO_FORMAT_BGRA || frame->format == VIDEO_FORMAT_BGRX)
       ? cv::COLOR_BGR2BGRA
       : cv::COLOR_BGR2RGBA;
-    cv::cvtColor(bgr_frame, dst_rgba, code);
+    cv::cvtColor(src, dst_rgba, code);
     return true;
   }
   case VIDEO_FORMAT_Y800: {
-    cv::Mat gray;
-    cv::cvtColor(bgr_frame, gray, cv::COLOR_BGR2GRAY);
-    return CopyLinearToPlane(
-      gray.data,
-      frame->data[0],
-      static_cast<std::size_t>(frame->linesize[0]),
-      static_cast<std::size_t>(width),
-      height);
+    const cv::Mat src = bgr_frame(rect);
+    cv::Mat dst_gray(rect.height, rect.width, CV_8UC1, frame->data[0] + y * stride0 + x, stride0);
+    cv::cvtColor(src, dst_gray, cv::COLOR_BGR2GRAY);
+    return true;
   }
   case VIDEO_FORMAT_YUY2: {
-    cv::Mat yuy2;
-    cv::cvtColor(bgr_frame, yuy2, cv::COLOR_BGR2YUV_YUY2);
-    return CopyLinearToPlane(
-      yuy2.data,
-      frame->data[0],
-      static_cast<std::size_t>(frame->linesize[0]),
-      static_cast<std::size_t>(width) * 2ULL,
-      height);
+    yuv_convert::BgrToYuy2(
+      bgr_frame.ptr(rect.y) + 3 * x, bgr_frame.step, frame->data[0] + y * stride0 + 2 * x, stride0, rect.width,
+      rect.height);
+    return true;
   }
   case VIDEO_FORMAT_UYVY: {
-    cv::Mat uyvy;
-    cv::cvtColor(bgr_frame, uyvy, cv::COLOR_BGR2YUV_UYVY);
-    return CopyLinearToPlane(
-      uyvy.data,
-      frame->data[0],
-      static_cast<std::size_t>(frame->linesize[0]),
-      static_cast<std::size_t>(width) * 2ULL,
-      height);
+    yuv_convert::BgrToUyvy(
+      bgr_frame.ptr(rect.y) + 3 * x, bgr_frame.step, frame->data[0] + y * stride0 + 2 * x, stride0, rect.width,
+      rect.height);
+    return true;
   }
-  case VIDEO_FORMAT_I420:
-  case VIDEO_FORMAT_NV12: {
-    cv::Mat i420;
-    cv::cvtColor(bgr_frame, i420, cv::COLOR_BGR2YUV_I420);
-
-    const std::size_t y_size = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
-    const int chroma_width = width / 2;
-    const int chroma_height = height / 2;
-    const std::size_t chroma_size = static_cast<std::size_t>(chroma_width) * static_cast<std::size_t>(chroma_height);
-
-    const uint8_t *src_y = i420.data;
-    const uint8_t *src_u = src_y + y_size;
-    const uint8_t *src_v = src_u + chroma_size;
-
-    if (!CopyLinearToPlane(
-          src_y,
-          frame->data[0],
-          static_cast<std::size_t>(frame->linesize[0]),
-          static_cast<std::size_t>(width),
-          height)) {
+  case VIDEO_FORMAT_I420: {
+    if (frame->data[1] == nullptr || frame->data[2] == nullptr) {
       return false;
     }
 
-    if (frame->format == VIDEO_FORMAT_I420) {
-      if (frame->data[1] == nullptr || frame->data[2] == nullptr) {
-        return false;
-      }
-
-      if (!CopyLinearToPlane(
-            src_u,
-            frame->data[1],
-            static_cast<std::size_t>(frame->linesize[1]),
-            static_cast<std::size_t>(chroma_width),
-            chroma_height)) {
-        return false;
-      }
-
-      return CopyLinearToPlane(
-        src_v,
-        frame->data[2],
-        static_cast<std::size_t>(frame->linesize[2]),
-        static_cast<std::size_t>(chroma_width),
-        chroma_height);
+    const std::size_t stride1 = static_cast<std::size_t>(frame->linesize[1]);
+    const std::size_t stride2 = static_cast<std::size_t>(frame->linesize[2]);
+    yuv_convert::BgrToI420(
+      bgr_frame.ptr(rect.y) + 3 * x,
+      bgr_frame.step,
+      frame->data[0] + y * stride0 + x,
+      stride0,
+      frame->data[1] + (y / 2) * stride1 + x / 2,
+      stride1,
+      frame->data[2] + (y / 2) * stride2 + x / 2,
+      stride2,
+      rect.width,
+      rect.height);
+    return true;
+  }
+  case VIDEO_FORMAT_NV12: {
+    if (frame->data[1] == nullptr || frame->linesize[1] < frame->width) {
+      return false;
     }
 
-    if (frame->data[1] == nullptr || frame->linesize[1] < static_cast<uint32_t>(width)) {
+    const std::size_t stride1 = static_cast<std::size_t>(frame->linesize[1]);
+    yuv_convert::BgrToNv12(
+      bgr_frame.ptr(rect.y) + 3 * x,
+      bgr_frame.step,
+      frame->data[0] + y * stride0 + x,
+      stride0,
+      frame->data[1] + (y / 2) * stride1 + x,
+      stride1,
+      rect.width,
+      rect.height);
+    return true;
+  }
+  case VIDEO_FORMAT_P010: {
+    if (frame->data[1] == nullptr) {
       return false;
     }
 
-    for (int row = 0; row < chroma_height; ++row) {
-      uint8_t *dst_uv = frame->data[1] + static_cast<std::size_t>(row) * static_cast<std::size_t>(frame->linesize[1]);
-      const uint8_t *row_u = src_u + static_cast<std::size_t>(row) * static_cast<std::size_t>(chroma_width);
-      const uint8_t *row_v = src_v + static_cast<std::size_t>(row) * static_cast<std::size_t>(chroma_width);
-      for (int col = 0; col < chroma_width; ++col) {
-        dst_uv[2 * col] = row_u[col];
-        dst_uv[2 * col + 1] = row_v[col];
-      }
+    // Convert the region to 8-bit NV12 in a small staging buffer, then widen
+    // back to 10-in-16; only the dirty region is touched either way.
+    cv::Mat y8(rect.height, rect.width, CV_8UC1);
+    cv::Mat uv8(rect.height / 2, rect.width / 2, CV_8UC2);
+    yuv_convert::BgrToNv12(
+      bgr_frame.ptr(rect.y) + 3 * x, bgr_frame.step, y8.data, y8.step, uv8.data, uv8.step, rect.width, rect.height);
+
+    const std::size_t stride1 = static_cast<std::size_t>(frame->linesize[1]);
+    yuv_convert::Widen8To10(
+      y8.data, y8.step, reinterpret_cast<uint16_t *>(frame->data[0] + y * stride0 + 2 * x), stride0, rect.width,
+      rect.height, 8);
+    yuv_convert::Widen8To10(
+      uv8.data, uv8.step, reinterpret_cast<uint16_t *>(frame->data[1] + (y / 2) * stride1 + 2 * x), stride1,
+      rect.width, rect.height / 2, 8);
+    return true;
+  }
+  case VIDEO_FORMAT_I010: {
+    if (frame->data[1] == nullptr || frame->data[2] == nullptr) {
+      return false;
     }
+
+    cv::Mat y8(rect.height, rect.width, CV_8UC1);
+    cv::Mat u8(rect.height / 2, rect.width / 2, CV_8UC1);
+    cv::Mat v8(rect.height / 2, rect.width / 2, CV_8UC1);
+    yuv_convert::BgrToI420(
+      bgr_frame.ptr(rect.y) + 3 * x, bgr_frame.step, y8.data, y8.step, u8.data, u8.step, v8.data, v8.step,
+      rect.width, rect.height);
+
+    const std::size_t stride1 = static_cast<std::size_t>(frame->linesize[1]);
+    const std::size_t stride2 = static_cast<std::size_t>(frame->linesize[2]);
+    yuv_convert::Widen8To10(
+      y8.data, y8.step, reinterpret_cast<uint16_t *>(frame->data[0] + y * stride0 + 2 * x), stride0, rect.width,
+      rect.height, 2);
+    yuv_convert::Widen8To10(
+      u8.data, u8.step, reinterpret_cast<uint16_t *>(frame->data[1] + (y / 2) * stride1 + x), stride1,
+      rect.width / 2, rect.height / 2, 2);
+    yuv_convert::Widen8To10(
+      v8.data, v8.step, reinterpret_cast<uint16_t *>(frame->data[2] + (y / 2) * stride2 + x), stride2,
+      rect.width / 2, rect.height / 2, 2);
     return true;
   }
   default:
@@ -750,12 +1413,75 @@ bool FaceEmotionFilter::SupportsFrameFormat(const video_format format)
   case VIDEO_FORMAT_YUY2:
   case VIDEO_FORMAT_UYVY:
   case VIDEO_FORMAT_Y800:
+  case VIDEO_FORMAT_P010:
+  case VIDEO_FORMAT_I010:
     return true;
   default:
     return false;
   }
 }
 
+bool FaceEmotionFilter::DetectMotion(const obs_source_frame *frame, const float threshold)
+{
+  const int width = static_cast<int>(frame->width);
+  const int height = static_cast<int>(frame->height);
+  const cv::Size thumb_size(kMotionGateWidth, kMotionGateHeight);
+
+  cv::Mat thumb;
+  switch (frame->format) {
+  case VIDEO_FORMAT_I420:
+  case VIDEO_FORMAT_NV12:
+  case VIDEO_FORMAT_Y800: {
+    const cv::Mat y_plane(height, width, CV_8UC1, frame->data[0], frame->linesize[0]);
+    cv::resize(y_plane, thumb, thumb_size, 0.0, 0.0, cv::INTER_AREA);
+    break;
+  }
+  case VIDEO_FORMAT_P010:
+  case VIDEO_FORMAT_I010: {
+    const cv::Mat y16(height, width, CV_16UC1, frame->data[0], frame->linesize[0]);
+    cv::Mat thumb16;
+    cv::resize(y16, thumb16, thumb_size, 0.0, 0.0, cv::INTER_AREA);
+    thumb16.convertTo(thumb, CV_8U, frame->format == VIDEO_FORMAT_P010 ? 1.0 / 256.0 : 1.0 / 4.0);
+    break;
+  }
+  case VIDEO_FORMAT_YUY2:
+  case VIDEO_FORMAT_UYVY: {
+    const cv::Mat packed(height, width, CV_8UC2, frame->data[0], frame->linesize[0]);
+    cv::Mat packed_thumb;
+    cv::resize(packed, packed_thumb, thumb_size, 0.0, 0.0, cv::INTER_AREA);
+    cv::extractChannel(packed_thumb, thumb, frame->format == VIDEO_FORMAT_YUY2 ? 0 : 1);
+    break;
+  }
+  case VIDEO_FORMAT_BGRA:
+  case VIDEO_FORMAT_BGRX:
+  case VIDEO_FORMAT_RGBA: {
+    const cv::Mat rgb(height, width, CV_8UC4, frame->data[0], frame->linesize[0]);
+    cv::Mat rgb_thumb;
+    cv::resize(rgb, rgb_thumb, thumb_size, 0.0, 0.0, cv::INTER_AREA);
+    cv::cvtColor(rgb_thumb, thumb, frame->format == VIDEO_FORMAT_RGBA ? cv::COLOR_RGBA2GRAY : cv::COLOR_BGRA2GRAY);
+    break;
+  }
+  default:
+    // No cheap luma view for this format; never suppress inference.
+    return true;
+  }
+
+  // The reference is the thumbnail of the last *submitted* frame, so slow
+  // creeping motion accumulates against it instead of being rediffed away.
+  if (motion_reference_.size() != thumb.size()) {
+    thumb.copyTo(motion_reference_);
+    return true;
+  }
+
+  const double mean_abs_diff =
+    cv::norm(thumb, motion_reference_, cv::NORM_L1) / static_cast<double>(thumb.total());
+  if (mean_abs_diff >= static_cast<double>(threshold)) {
+    thumb.copyTo(motion_reference_);
+    return true;
+  }
+  return false;
+}
+
 bool FaceEmotionFilter::SupportsInPlaceOverlay(const video_format format)
 {
   switch (format) {
@@ -799,13 +1525,13 @@ void FaceEmotionFilter::DrawOverlay(
 
     if (config.show_label) {
       const std::string text = BuildFaceText(face, config);
-      const int safe_padding = std::max(0, config.text_padding);
-      const int safe_text_thickness = std::max(1, config.text_thickness);
-      const double safe_text_scale = std::max(0.1, static_cast<double>(config.text_scale));
+      const LabelSprite *sprite = GetLabelSprite(text, config, text_color);
+      if (sprite == nullptr) {
+        continue;
+      }
 
-      int baseline = 0;
-      const cv::Size text_size =
-        cv::getTextSize(text, cv::FONT_HERSHEY_SIMPLEX, safe_text_scale, safe_text_thickness, &baseline);
+      const int safe_padding = std::max(0, config.text_padding);
+      const cv::Size text_size(sprite->premultiplied.cols - 4, sprite->premultiplied.rows - sprite->baseline - 4);
 
       int text_x = bbox.x;
       int text_y = bbox.y - (safe_padding + 4);
@@ -825,16 +1551,7 @@ void FaceEmotionFilter::DrawOverlay(
         std::max(0, std::min(text_size.height + (2 * safe_padding), draw_frame.rows - rect_y)));
 
       FillRectWithOpacity(&draw_frame, label_rect, cv::Scalar(0, 0, 0, 255), config.text_bg_opacity);
-      DrawTextWithOpacity(
-        &draw_frame,
-        text,
-        cv::Point(text_x, text_y),
-        cv::FONT_HERSHEY_SIMPLEX,
-        safe_text_scale,
-        text_color,
-        safe_text_thickness,
-        cv::LINE_AA,
-        config.text_opacity);
+      BlitLabelSprite(&draw_frame, sprite->premultiplied, sprite->alpha, text_x - 2, text_y - text_size.height - 2);
     }
   }
 }
@@ -842,7 +1559,8 @@ void FaceEmotionFilter::DrawOverlay(
 void FaceEmotionFilter::DrawOverlayOnBgr(
   cv::Mat *bgr_frame,
   const std::vector<DetectedFace> &faces,
-  const FilterConfig &config) const
+  const FilterConfig &config,
+  std::vector<cv::Rect> *dirty_rects) const
 {
   if (bgr_frame == nullptr || bgr_frame->empty() || bgr_frame->type() != CV_8UC3 || (!config.show_box && !config.show_label)) {
     return;
@@ -861,17 +1579,20 @@ void FaceEmotionFilter::DrawOverlayOnBgr(
 
     if (config.show_box) {
       cv::rectangle(*bgr_frame, bbox, box_color, config.box_thickness, cv::LINE_AA);
+      if (dirty_rects != nullptr) {
+        AppendBoxOutlineRects(bbox, config.box_thickness, bounds, dirty_rects);
+      }
     }
 
     if (config.show_label) {
       const std::string text = BuildFaceText(face, config);
-      const int safe_padding = std::max(0, config.text_padding);
-      const int safe_text_thickness = std::max(1, config.text_thickness);
-      const double safe_text_scale = std::max(0.1, static_cast<double>(config.text_scale));
+      const LabelSprite *sprite = GetLabelSprite(text, config, text_color);
+      if (sprite == nullptr) {
+        continue;
+      }
 
-      int baseline = 0;
-      const cv::Size text_size =
-        cv::getTextSize(text, cv::FONT_HERSHEY_SIMPLEX, safe_text_scale, safe_text_thickness, &baseline);
+      const int safe_padding = std::max(0, config.text_padding);
+      const cv::Size text_size(sprite->premultiplied.cols - 4, sprite->premultiplied.rows - sprite->baseline - 4);
 
       int text_x = bbox.x;
       int text_y = bbox.y - (safe_padding + 4);
@@ -891,18 +1612,261 @@ void FaceEmotionFilter::DrawOverlayOnBgr(
         std::max(0, std::min(text_size.height + (2 * safe_padding), bgr_frame->rows - rect_y)));
 
       FillRectWithOpacity(bgr_frame, label_rect, cv::Scalar(0, 0, 0), config.text_bg_opacity);
-      DrawTextWithOpacity(
-        bgr_frame,
-        text,
-        cv::Point(text_x, text_y),
-        cv::FONT_HERSHEY_SIMPLEX,
-        safe_text_scale,
-        text_color,
-        safe_text_thickness,
-        cv::LINE_AA,
-        config.text_opacity);
+      BlitLabelSprite(bgr_frame, sprite->premultiplied, sprite->alpha, text_x - 2, text_y - text_size.height - 2);
+
+      if (dirty_rects != nullptr) {
+        // Descenders reach below the padded label rect, so union with the
+        // sprite extent (glyphs, baseline and anti-aliasing margin).
+        const cv::Rect text_bounds(
+          text_x - 2, text_y - text_size.height - 2, sprite->premultiplied.cols, sprite->premultiplied.rows);
+        const cv::Rect dirty = (label_rect | text_bounds) & bounds;
+        if (!dirty.empty()) {
+          dirty_rects->push_back(dirty);
+        }
+      }
+    }
+  }
+}
+
+void FaceEmotionFilter::RenderOverlay(gs_effect_t *)
+{
+  if (source_ == nullptr) {
+    return;
+  }
+
+  const std::shared_ptr<const FilterConfig> config_snapshot = std::atomic_load(&config_);
+  const FilterConfig &local_config = *config_snapshot;
+
+  // Render the unmodified chain below us first; the overlay composites on top.
+  obs_source_skip_video_filter(source_);
+
+  if (!local_config.enabled || !local_config.gpu_overlay || (!local_config.show_box && !local_config.show_label)) {
+    return;
+  }
+
+  std::vector<DetectedFace> faces;
+  {
+    std::scoped_lock lock(overlay_mutex_);
+    faces = overlay_faces_;
+  }
+  if (faces.empty()) {
+    return;
+  }
+
+  obs_source_t *target = obs_filter_get_target(source_);
+  const int frame_width = target != nullptr ? static_cast<int>(obs_source_get_base_width(target)) : 0;
+  const int frame_height = target != nullptr ? static_cast<int>(obs_source_get_base_height(target)) : 0;
+  if (frame_width <= 0 || frame_height <= 0) {
+    return;
+  }
+
+  gs_effect_t *solid = obs_get_base_effect(OBS_EFFECT_SOLID);
+  gs_effect_t *draw_effect = obs_get_base_effect(OBS_EFFECT_DEFAULT);
+  if (solid == nullptr || draw_effect == nullptr) {
+    return;
+  }
+
+  gs_blend_state_push();
+  gs_blend_function(GS_BLEND_ONE, GS_BLEND_INVSRCALPHA);
+
+  const cv::Rect bounds(0, 0, frame_width, frame_height);
+  for (const auto &face : faces) {
+    const cv::Rect bbox = face.bbox & bounds;
+    if (bbox.empty()) {
+      continue;
+    }
+
+    const cv::Scalar box_color = ResolveBoxColor(local_config, face.label);
+    const cv::Scalar text_color = ResolveTextColor(local_config, face.label);
+
+    if (local_config.show_box) {
+      const int thickness = std::min(std::max(1, local_config.box_thickness), std::min(bbox.width, bbox.height) / 2);
+      DrawSolidRect(solid, cv::Rect(bbox.x, bbox.y, bbox.width, thickness), box_color, 255);
+      DrawSolidRect(solid, cv::Rect(bbox.x, bbox.y + bbox.height - thickness, bbox.width, thickness), box_color, 255);
+      DrawSolidRect(solid, cv::Rect(bbox.x, bbox.y, thickness, bbox.height), box_color, 255);
+      DrawSolidRect(solid, cv::Rect(bbox.x + bbox.width - thickness, bbox.y, thickness, bbox.height), box_color, 255);
+    }
+
+    if (local_config.show_label) {
+      const std::string text = BuildFaceText(face, local_config);
+      const LabelTexture *sprite = GetLabelTexture(text, local_config, text_color);
+      if (sprite == nullptr) {
+        continue;
+      }
+
+      // Same placement math as the CPU draw paths.
+      const int safe_padding = std::max(0, local_config.text_padding);
+      const int text_width = static_cast<int>(sprite->width) - 4;
+      const int text_height = static_cast<int>(sprite->height) - sprite->baseline - 4;
+
+      int text_x = bbox.x;
+      int text_y = bbox.y - (safe_padding + 4);
+      if (text_y < text_height + safe_padding) {
+        text_y = bbox.y + text_height + safe_padding + 4;
+      }
+      if (text_x + text_width + (2 * safe_padding) > frame_width) {
+        text_x = std::max(0, frame_width - text_width - (2 * safe_padding));
+      }
+
+      if (local_config.text_bg_opacity > 0) {
+        const int rect_x = std::max(0, text_x - safe_padding);
+        const int rect_y = std::max(0, text_y - text_height - safe_padding);
+        const cv::Rect label_rect(
+          rect_x,
+          rect_y,
+          std::max(0, std::min(text_width + (2 * safe_padding), frame_width - rect_x)),
+          std::max(0, std::min(text_height + (2 * safe_padding), frame_height - rect_y)));
+        if (!label_rect.empty()) {
+          DrawSolidRect(solid, label_rect, cv::Scalar(0, 0, 0), local_config.text_bg_opacity);
+        }
+      }
+
+      DrawTextureSprite(draw_effect, sprite->texture, text_x - 2, text_y - text_height - 2);
+    }
+  }
+
+  gs_blend_state_pop();
+}
+
+const FaceEmotionFilter::LabelSprite *
+FaceEmotionFilter::GetLabelSprite(const std::string &text, const FilterConfig &config, const cv::Scalar &color) const
+{
+  const int thickness = std::max(1, config.text_thickness);
+  const double scale = std::max(0.1, static_cast<double>(config.text_scale));
+  const int opacity = std::clamp(config.text_opacity, 0, 255);
+
+  const std::string key = BuildLabelKey(text, scale, thickness, color, opacity);
+  const auto found = label_sprites_.find(key);
+  if (found != label_sprites_.end()) {
+    found->second.last_used = ++label_sprite_counter_;
+    return &found->second;
+  }
+
+  int baseline = 0;
+  const cv::Size text_size = cv::getTextSize(text, cv::FONT_HERSHEY_SIMPLEX, scale, thickness, &baseline);
+  if (text_size.width <= 0 || text_size.height <= 0) {
+    return nullptr;
+  }
+
+  // Glyph coverage from anti-aliased white-on-black text; the text opacity is
+  // folded into the coverage so the blit is a single blend per pixel.
+  cv::Mat coverage = cv::Mat::zeros(text_size.height + baseline + 4, text_size.width + 4, CV_8UC1);
+  cv::putText(
+    coverage, text, cv::Point(2, text_size.height + 2), cv::FONT_HERSHEY_SIMPLEX, scale, cv::Scalar(255), thickness,
+    cv::LINE_AA);
+  if (opacity < 255) {
+    coverage.convertTo(coverage, -1, static_cast<double>(opacity) / 255.0);
+  }
+
+  cv::Mat channels[3];
+  for (int channel = 0; channel < 3; ++channel) {
+    channels[channel] = coverage * (color[channel] / 255.0);
+  }
+
+  LabelSprite entry;
+  cv::merge(channels, 3, entry.premultiplied);
+  entry.alpha = std::move(coverage);
+  entry.baseline = baseline;
+  entry.last_used = ++label_sprite_counter_;
+
+  if (label_sprites_.size() >= kMaxCachedLabels) {
+    auto oldest = label_sprites_.begin();
+    for (auto it = label_sprites_.begin(); it != label_sprites_.end(); ++it) {
+      if (it->second.last_used < oldest->second.last_used) {
+        oldest = it;
+      }
     }
+    label_sprites_.erase(oldest);
   }
+
+  return &label_sprites_.emplace(key, std::move(entry)).first->second;
+}
+
+const FaceEmotionFilter::LabelTexture *
+FaceEmotionFilter::GetLabelTexture(const std::string &text, const FilterConfig &config, const cv::Scalar &color)
+{
+  const int thickness = std::max(1, config.text_thickness);
+  const double scale = std::max(0.1, static_cast<double>(config.text_scale));
+  const int opacity = std::clamp(config.text_opacity, 0, 255);
+
+  const std::string key = BuildLabelKey(text, scale, thickness, color, opacity);
+  const auto found = label_textures_.find(key);
+  if (found != label_textures_.end()) {
+    found->second.last_used = ++label_texture_counter_;
+    return &found->second;
+  }
+
+  const LabelSprite *sprite = GetLabelSprite(text, config, color);
+  if (sprite == nullptr) {
+    return nullptr;
+  }
+
+  // The sprite already carries coverage-scaled color, i.e. premultiplied
+  // alpha; append the coverage as the alpha channel for the GPU blend.
+  cv::Mat bgr_channels[3];
+  cv::split(sprite->premultiplied, bgr_channels);
+  const cv::Mat bgra_channels[] = {bgr_channels[0], bgr_channels[1], bgr_channels[2], sprite->alpha};
+  cv::Mat bgra;
+  cv::merge(bgra_channels, 4, bgra);
+
+  const uint8_t *sprite_data = bgra.data;
+  gs_texture_t *texture = gs_texture_create(
+    static_cast<uint32_t>(bgra.cols), static_cast<uint32_t>(bgra.rows), GS_BGRA, 1, &sprite_data, 0);
+  if (texture == nullptr) {
+    return nullptr;
+  }
+
+  if (label_textures_.size() >= kMaxCachedLabels) {
+    auto oldest = label_textures_.begin();
+    for (auto it = label_textures_.begin(); it != label_textures_.end(); ++it) {
+      if (it->second.last_used < oldest->second.last_used) {
+        oldest = it;
+      }
+    }
+    gs_texture_destroy(oldest->second.texture);
+    label_textures_.erase(oldest);
+  }
+
+  LabelTexture entry;
+  entry.texture = texture;
+  entry.width = static_cast<uint32_t>(bgra.cols);
+  entry.height = static_cast<uint32_t>(bgra.rows);
+  entry.baseline = sprite->baseline;
+  entry.last_used = ++label_texture_counter_;
+  return &label_textures_.emplace(key, entry).first->second;
+}
+
+void FaceEmotionFilter::ClearLabelTextures()
+{
+  if (label_textures_.empty()) {
+    return;
+  }
+
+  obs_enter_graphics();
+  for (auto &[key, entry] : label_textures_) {
+    gs_texture_destroy(entry.texture);
+  }
+  obs_leave_graphics();
+  label_textures_.clear();
+}
+
+void FaceEmotionFilter::EmitResultsSignal(const std::vector<DetectedFace> &faces, const uint64_t timestamp_ns)
+{
+  signal_handler_t *handler = obs_source_get_signal_handler(source_);
+  if (handler == nullptr) {
+    return;
+  }
+
+  // Zero-copy: faces points straight into latest_faces_, so handlers must
+  // copy anything they keep past the callback.
+  uint8_t stack[128];
+  calldata_t data;
+  calldata_init_fixed(&data, stack, sizeof(stack));
+  calldata_set_ptr(&data, "source", source_);
+  calldata_set_ptr(&data, "faces", const_cast<DetectedFace *>(faces.data()));
+  calldata_set_int(&data, "count", static_cast<long long>(faces.size()));
+  calldata_set_int(&data, "timestamp_ns", static_cast<long long>(timestamp_ns));
+  signal_handler_signal(handler, "face_emotion_results", &data);
 }
 
 void FaceEmotionFilter::LogPerfEveryFiveSeconds(const uint64_t now_ns)
@@ -918,7 +1882,6 @@ void FaceEmotionFilter::LogPerfEveryFiveSeconds(const uint64_t now_ns)
   }
 
   const double elapsed_seconds = static_cast<double>(elapsed_ns) / static_cast<double>(kOneSecondNs);
-  const double avg_inference_ms = perf_samples_ > 0 ? perf_total_ms_ / static_cast<double>(perf_samples_) : 0.0;
   const double inference_fps = elapsed_seconds > 0.0 ? static_cast<double>(perf_results_) / elapsed_seconds : 0.0;
   const char *top_label = "none";
   float top_conf = 0.0f;
@@ -929,16 +1892,39 @@ void FaceEmotionFilter::LogPerfEveryFiveSeconds(const uint64_t now_ns)
 
   obs_log(
     LOG_INFO,
-    "perf avg_inference_ms=%.2f inference_fps=%.2f queue=%zu top_label=%s top_conf=%.2f",
-    avg_inference_ms,
+    "perf inference_fps=%.2f queue=%zu width=%d top_label=%s top_conf=%.2f",
     inference_fps,
-    worker_.QueueSize(),
+    worker_ != nullptr ? worker_->QueueSize() : static_cast<std::size_t>(0),
+    worker_ != nullptr ? worker_->EffectiveInferenceWidth(client_id_) : 0,
     top_label,
     top_conf);
 
+  // Windowed tail latency per stage; means hide exactly the spikes that drop
+  // frames, so every stage reports p50/p95/p99 over the elapsed window. The
+  // worker-side histograms are cumulative and shared, hence the baselines.
+  if (worker_ != nullptr) {
+    const StageLatencyStats &worker_stats = worker_->Stats();
+    const StagePercentiles extract = WindowPercentiles(stage_stats_.extract, &perf_baselines_.extract);
+    const StagePercentiles queue_wait = WindowPercentiles(worker_stats.queue_wait, &perf_baselines_.queue_wait);
+    const StagePercentiles detect = WindowPercentiles(worker_stats.detect, &perf_baselines_.detect);
+    const StagePercentiles emotion = WindowPercentiles(worker_stats.emotion, &perf_baselines_.emotion);
+    const StagePercentiles tracker = WindowPercentiles(worker_stats.tracker, &perf_baselines_.tracker);
+    const StagePercentiles overlay = WindowPercentiles(stage_stats_.overlay, &perf_baselines_.overlay);
+    const StagePercentiles write_back = WindowPercentiles(stage_stats_.write_back, &perf_baselines_.write_back);
+    obs_log(
+      LOG_INFO,
+      "perf_ms(p50/p95/p99) extract=%.1f/%.1f/%.1f queue_wait=%.1f/%.1f/%.1f detect=%.1f/%.1f/%.1f "
+      "emotion=%.1f/%.1f/%.1f tracker=%.1f/%.1f/%.1f overlay=%.1f/%.1f/%.1f write_back=%.1f/%.1f/%.1f",
+      extract.p50, extract.p95, extract.p99,
+      queue_wait.p50, queue_wait.p95, queue_wait.p99,
+      detect.p50, detect.p95, detect.p99,
+      emotion.p50, emotion.p95, emotion.p99,
+      tracker.p50, tracker.p95, tracker.p99,
+      overlay.p50, overlay.p95, overlay.p99,
+      write_back.p50, write_back.p95, write_back.p99);
+  }
+
   perf_window_start_ns_ = now_ns;
-  perf_total_ms_ = 0.0;
-  perf_samples_ = 0;
   perf_results_ = 0;
 }
 
@@ -953,6 +1939,31 @@ std::string FaceEmotionFilter::ResolveModelPath(const char *model_name) const
   return path.string();
 }
 
+std::string FaceEmotionFilter::ResolveModelVariant(const char *model_name, const std::string &precision) const
+{
+  const std::string base_path = ResolveModelPath(model_name);
+  if (base_path.empty() || precision == kModelPrecisionFp32) {
+    return base_path;
+  }
+
+  // Quantized variants live next to the FP32 files as <stem>-<precision>.onnx
+  // or <stem>_<precision>.onnx (the upstream YuNet int8 release uses the
+  // underscore form). Missing variants fall back to FP32.
+  const std::filesystem::path base(base_path);
+  const std::string stem = base.stem().string();
+  const std::string extension = base.extension().string();
+  for (const char separator : {'-', '_'}) {
+    const std::filesystem::path candidate = base.parent_path() / (stem + separator + precision + extension);
+    if (std::filesystem::exists(candidate)) {
+      obs_log(LOG_INFO, "using %s model variant: %s", precision.c_str(), candidate.filename().string().c_str());
+      return candidate.string();
+    }
+  }
+
+  obs_log(LOG_INFO, "no %s variant of %s found; using FP32", precision.c_str(), model_name);
+  return base_path;
+}
+
 InferenceWorker::Config FaceEmotionFilter::BuildWorkerConfig(const FilterConfig &filter_config)
 {
   InferenceWorker::Config config;
@@ -960,6 +1971,16 @@ InferenceWorker::Config FaceEmotionFilter::BuildWorkerConfig(const FilterConfig
   config.inference_width = filter_config.inference_width;
   config.confidence_threshold = filter_config.confidence_threshold;
   config.smoothing_seconds = filter_config.smoothing_seconds;
+  config.backend = filter_config.dnn_backend;
+  config.cache_dir = filter_config.dnn_cache_dir;
+  config.adaptive_width = filter_config.adaptive_width;
+  config.target_latency_ms = filter_config.target_latency_ms;
+  config.low_priority = filter_config.worker_low_priority;
+  config.affinity_mask = filter_config.worker_affinity_mask;
+  config.opencv_threads = filter_config.opencv_threads;
+  config.fixed_detector_input = filter_config.fixed_detector_input;
+  config.roi_detection = filter_config.roi_detection;
+  config.full_sweep_interval_s = filter_config.full_sweep_interval_s;
   return config;
 }
 
@@ -979,6 +2000,7 @@ const obs_source_info *GetFaceEmotionFilterSourceInfo()
     info.get_properties = FilterGetProperties;
     info.video_tick = FilterTick;
     info.filter_video = FilterVideo;
+    info.video_render = FilterVideoRender;
     initialized = true;
   }
 
@@ -1,13 +1,18 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
+#include <deque>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <obs-module.h>
 
 #include "inference_worker.hpp"
+#include "latency_stats.hpp"
 
 struct FilterConfig {
   bool enabled = true;
@@ -16,6 +21,28 @@ struct FilterConfig {
   int inference_width = 640;
   float confidence_threshold = 0.30f;
   float smoothing_seconds = 0.6f;
+  float motion_threshold = 0.0f;
+  // Synchronized mode: hold frames until their matching inference result
+  // arrives (or the deadline passes), trading a small fixed delay for
+  // overlays registered to the frame they were computed from.
+  bool sync_mode = false;
+  int sync_deadline_ms = 50;
+  bool adaptive_width = false;
+  float target_latency_ms = 33.0f;
+  // Two-tier detection schedule: ROI scans around known tracks with periodic
+  // full-frame sweeps; applies without a worker restart.
+  bool roi_detection = false;
+  float full_sweep_interval_s = 1.0f;
+  // Worker thread scheduling; changes restart the worker since the thread
+  // applies them once at startup.
+  bool worker_low_priority = false;
+  uint64_t worker_affinity_mask = 0;
+  int opencv_threads = 0;
+  // Constant-sized letterboxed detector input; bound at worker start, so a
+  // change restarts the worker.
+  bool fixed_detector_input = false;
+  InferenceWorker::DnnBackend dnn_backend = InferenceWorker::DnnBackend::kAuto;
+  std::string model_precision = "fp32";
   bool show_confidence = true;
   bool show_box = true;
   bool box_use_emotion_color = true;
@@ -25,6 +52,7 @@ struct FilterConfig {
   int box_thickness = 2;
   bool show_label = true;
   bool show_track_id = false;
+  bool gpu_overlay = false;
   bool text_use_emotion_color = true;
   int text_color_r = 255;
   int text_color_g = 255;
@@ -35,6 +63,8 @@ struct FilterConfig {
   int text_padding = 4;
   int text_bg_opacity = 0;
   std::string low_conf_label = "Incertain";
+  // Module config directory for on-disk kernel caches; not a user setting.
+  std::string dnn_cache_dir;
 };
 
 class FaceEmotionFilter {
@@ -45,36 +75,114 @@ public:
   void Update(obs_data_t *settings);
   void Tick(float seconds);
   obs_source_frame *FilterVideo(obs_source_frame *frame);
+  void RenderOverlay(gs_effect_t *effect);
 
   static void GetDefaults(obs_data_t *settings);
   static obs_properties_t *GetProperties();
 
 private:
   static uint64_t GetTimestampNs(const obs_source_frame *frame);
-  bool ExtractBgrFrame(const obs_source_frame *frame, cv::Mat *bgr_frame) const;
-  bool WriteBgrFrame(obs_source_frame *frame, const cv::Mat &bgr_frame) const;
+  bool ExtractBgrFrame(const obs_source_frame *frame, cv::Mat *bgr_frame, int target_width = 0) const;
+  static bool ExtractGrayFrame(const obs_source_frame *frame, cv::Mat *gray_frame, int target_width = 0);
+  bool WriteBgrFrame(obs_source_frame *frame, const cv::Mat &bgr_frame,
+                     const std::vector<cv::Rect> *dirty_rects = nullptr) const;
+  static bool WriteBgrRegion(obs_source_frame *frame, const cv::Mat &bgr_frame, const cv::Rect &rect);
   static bool SupportsFrameFormat(video_format format);
+  bool DetectMotion(const obs_source_frame *frame, float threshold);
   static bool SupportsInPlaceOverlay(video_format format);
   void DrawOverlay(obs_source_frame *frame, const std::vector<DetectedFace> &faces, const FilterConfig &config);
-  void DrawOverlayOnBgr(cv::Mat *bgr_frame, const std::vector<DetectedFace> &faces, const FilterConfig &config) const;
+  void DrawOverlayOnBgr(cv::Mat *bgr_frame, const std::vector<DetectedFace> &faces, const FilterConfig &config,
+                        std::vector<cv::Rect> *dirty_rects = nullptr) const;
+  // Publishes a consumed result through the "face_emotion_results" signal on
+  // this source's signal handler; the faces pointer is borrowed for the
+  // duration of the emission only.
+  void EmitResultsSignal(const std::vector<DetectedFace> &faces, uint64_t timestamp_ns);
+  // Sync-mode frame exchange: enqueues the incoming frame and returns the
+  // oldest held frame once its result arrived, its deadline passed or the
+  // ring overflowed; nullptr means the frame stays held this call.
+  obs_source_frame *SyncModeExchangeFrame(obs_source_frame *frame, const FilterConfig &config);
+  void ClearSyncRing();
   void LogPerfEveryFiveSeconds(uint64_t now_ns);
   std::string ResolveModelPath(const char *model_name) const;
+  std::string ResolveModelVariant(const char *model_name, const std::string &precision) const;
   static InferenceWorker::Config BuildWorkerConfig(const FilterConfig &filter_config);
 
+  // Pre-rendered label sprite for the CPU draw paths: coverage-scaled color
+  // plus the glyph coverage map, cached per text and style so anti-aliased
+  // rasterization happens once per label change instead of once per frame.
+  struct LabelSprite {
+    cv::Mat premultiplied;  // CV_8UC3, color scaled by glyph coverage
+    cv::Mat alpha;          // CV_8UC1 coverage, text opacity folded in
+    int baseline = 0;
+    uint64_t last_used = 0;
+  };
+
+  // Pre-rendered label texture for the GPU overlay path, built from the same
+  // sprite rasterization.
+  struct LabelTexture {
+    gs_texture_t *texture = nullptr;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    int baseline = 0;
+    uint64_t last_used = 0;
+  };
+
+  const LabelSprite *GetLabelSprite(const std::string &text, const FilterConfig &config, const cv::Scalar &color) const;
+  const LabelTexture *GetLabelTexture(const std::string &text, const FilterConfig &config, const cv::Scalar &color);
+  void ClearLabelTextures();
+
   obs_source_t *source_ = nullptr;
-  FilterConfig config_;
-  mutable std::mutex config_mutex_;
-  InferenceWorker worker_;
+  // RCU-style settings: Update publishes an immutable snapshot and the hot
+  // paths (video and graphics threads) load the pointer atomically, so
+  // per-frame config access takes no lock and copies nothing. Accessed
+  // through the shared_ptr atomic free functions past construction.
+  std::shared_ptr<const FilterConfig> config_ = std::make_shared<const FilterConfig>();
+  // Resolved at construction; kept so a backend change can restart the worker.
+  std::string face_model_path_;
+  std::string emotion_model_path_;
+  std::string dnn_cache_dir_;
+  // Shared across filter instances via InferenceService; this filter's own
+  // tracker and result state live behind client_id_.
+  std::shared_ptr<InferenceWorker> worker_;
+  InferenceWorker::ClientId client_id_ = 0;
   bool worker_ready_ = false;
   bool warned_unsupported_format_ = false;
   uint64_t last_submitted_ts_ns_ = 0;
+  // Luma thumbnail of the last submitted frame for the motion gate.
+  cv::Mat motion_reference_;
 
   std::vector<DetectedFace> latest_faces_;
+  // Timestamp of the frame the latest consumed result was computed from.
+  uint64_t latest_result_ts_ns_ = 0;
+
+  // Frames held back by sync mode, oldest first; only touched on the video
+  // thread (and in the destructor, after the pipeline stopped).
+  struct PendingSyncFrame {
+    obs_source_frame *frame = nullptr;
+    std::chrono::steady_clock::time_point enqueued_at {};
+  };
+  std::deque<PendingSyncFrame> sync_ring_;
+
+  // Snapshot of latest_faces_ for the graphics thread; FilterVideo runs on the
+  // video thread while RenderOverlay runs during compositing.
+  std::mutex overlay_mutex_;
+  std::vector<DetectedFace> overlay_faces_;
+
+  // Mutable so the const CPU draw path can populate it; only touched from the
+  // video thread (sprites) and graphics thread (textures) respectively.
+  mutable std::unordered_map<std::string, LabelSprite> label_sprites_;
+  mutable uint64_t label_sprite_counter_ = 0;
+
+  std::unordered_map<std::string, LabelTexture> label_textures_;
+  uint64_t label_texture_counter_ = 0;
 
   uint64_t perf_window_start_ns_ = 0;
-  double perf_total_ms_ = 0.0;
-  uint64_t perf_samples_ = 0;
   uint64_t perf_results_ = 0;
+  // Video-thread stage histograms (extract, overlay, write-back); the
+  // worker-side stages come from worker_->Stats(). The baselines window both
+  // sets between periodic logs.
+  StageLatencyStats stage_stats_;
+  StageLatencyBaselines perf_baselines_;
 };
 
 const obs_source_info *GetFaceEmotionFilterSourceInfo();
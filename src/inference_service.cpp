@@ -0,0 +1,71 @@
+#include "inference_service.hpp"
+
+#include <sstream>
+
+#include <plugin-support.h>
+
+namespace {
+
+InferenceService *service_instance = nullptr;
+
+std::string BuildWorkerKey(
+  const std::string &face_model_path,
+  const std::string &emotion_model_path,
+  const InferenceWorker::Config &config)
+{
+  std::ostringstream key_builder;
+  key_builder << face_model_path << '|' << emotion_model_path << '|' << static_cast<int>(config.backend);
+  return key_builder.str();
+}
+
+} // namespace
+
+void InferenceService::Load()
+{
+  if (service_instance == nullptr) {
+    service_instance = new InferenceService();
+  }
+}
+
+void InferenceService::Unload()
+{
+  delete service_instance;
+  service_instance = nullptr;
+}
+
+InferenceService *InferenceService::Instance()
+{
+  return service_instance;
+}
+
+std::shared_ptr<InferenceWorker> InferenceService::AcquireWorker(
+  const std::string &face_model_path,
+  const std::string &emotion_model_path,
+  const InferenceWorker::Config &config,
+  std::string *error)
+{
+  const std::string key = BuildWorkerKey(face_model_path, emotion_model_path, config);
+
+  std::scoped_lock lock(mutex_);
+
+  // Drop entries whose last user released the worker.
+  for (auto it = workers_.begin(); it != workers_.end();) {
+    it = it->second.expired() ? workers_.erase(it) : std::next(it);
+  }
+
+  const auto found = workers_.find(key);
+  if (found != workers_.end()) {
+    if (std::shared_ptr<InferenceWorker> existing = found->second.lock()) {
+      return existing;
+    }
+  }
+
+  auto worker = std::make_shared<InferenceWorker>();
+  if (!worker->Start(face_model_path, emotion_model_path, config, error)) {
+    return nullptr;
+  }
+
+  workers_[key] = worker;
+  obs_log(LOG_INFO, "inference service started shared worker (%zu active)", workers_.size());
+  return worker;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "inference_worker.hpp"
+
+// Process-wide inference service. Filters acquire a shared InferenceWorker
+// keyed by model paths and backend, so running the filter on many sources
+// loads each model once and schedules all sources on one worker thread per
+// configuration instead of one per filter. Lifetime is reference-counted:
+// the worker stops when the last filter using its configuration releases it.
+class InferenceService {
+public:
+  // Called from obs_module_load/obs_module_unload.
+  static void Load();
+  static void Unload();
+  static InferenceService *Instance();
+
+  // Returns the shared worker for this model/backend configuration, starting
+  // it on first use. Returns nullptr (with *error set) when the worker cannot
+  // start. Callers register themselves as clients on the returned worker.
+  std::shared_ptr<InferenceWorker> AcquireWorker(
+    const std::string &face_model_path,
+    const std::string &emotion_model_path,
+    const InferenceWorker::Config &config,
+    std::string *error);
+
+private:
+  InferenceService() = default;
+
+  std::mutex mutex_;
+  std::map<std::string, std::weak_ptr<InferenceWorker>> workers_;
+};
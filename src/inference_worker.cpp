@@ -4,17 +4,59 @@
 #include <array>
 #include <chrono>
 #include <cmath>
+#include <cstdlib>
 #include <exception>
 #include <limits>
 
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#include <pthread/qos.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include <opencv2/imgproc.hpp>
 
+#include <plugin-support.h>
+
 namespace {
 
-// Keep only the latest frame to minimize overlay latency under load.
-constexpr std::size_t kMaxQueueSize = 1;
+// Pending frames in flight across all clients plus a couple of buffers on each
+// side; anything beyond that is a resolution change leftover.
+constexpr std::size_t kFramePoolCapacity = 8;
 constexpr int kEmotionInputSize = 64;
 
+// ROI re-detection: how far past the tracked box each crop reaches, and the
+// smallest crop worth handing the detector.
+constexpr double kRoiExpandFactor = 1.8;
+constexpr int kRoiMinSide = 96;
+
+// Adaptive-width controller: never step below the detector's native 320
+// columns, move in coarse steps so the controller settles quickly, and only
+// adjust every few results so one outlier cannot thrash the resolution.
+constexpr int kAdaptiveWidthFloor = 320;
+constexpr int kAdaptiveWidthStep = 64;
+constexpr int kAdaptiveAdjustInterval = 8;
+constexpr double kAdaptiveEmaWeight = 0.2;
+// Hysteresis band around the latency budget; inside it the width holds.
+constexpr double kAdaptiveOverBudgetRatio = 1.15;
+constexpr double kAdaptiveUnderBudgetRatio = 0.70;
+
+double MillisecondsSince(const std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(std::chrono::steady_clock::now() - start)
+    .count();
+}
+
 cv::Rect ClampRectToFrame(const cv::Rect &rect, const int width, const int height)
 {
   const cv::Rect frame_rect(0, 0, width, height);
@@ -40,6 +82,175 @@ cv::Rect MakeSquareRect(const cv::Rect &rect, const int frame_width, const int f
   return square;
 }
 
+// Expanded neighborhoods of the previous result's tracks, mapped from source
+// to inference-frame coordinates and merged where they overlap so no face is
+// reported twice across two crops.
+std::vector<cv::Rect> BuildRoiRects(
+  const std::vector<cv::Rect> &track_boxes, const double map_x, const double map_y, const cv::Size &frame_size)
+{
+  std::vector<cv::Rect> rois;
+  rois.reserve(track_boxes.size());
+  const cv::Rect frame_rect(0, 0, frame_size.width, frame_size.height);
+  for (const cv::Rect &source_box : track_boxes) {
+    const int width = static_cast<int>(std::round(source_box.width / map_x));
+    const int height = static_cast<int>(std::round(source_box.height / map_y));
+    const int cx = static_cast<int>(std::round((source_box.x + source_box.width / 2.0) / map_x));
+    const int cy = static_cast<int>(std::round((source_box.y + source_box.height / 2.0) / map_y));
+    const int roi_w = std::max(kRoiMinSide, static_cast<int>(std::round(width * kRoiExpandFactor)));
+    const int roi_h = std::max(kRoiMinSide, static_cast<int>(std::round(height * kRoiExpandFactor)));
+    const cv::Rect roi = cv::Rect(cx - roi_w / 2, cy - roi_h / 2, roi_w, roi_h) & frame_rect;
+    if (roi.width >= kRoiMinSide / 2 && roi.height >= kRoiMinSide / 2) {
+      rois.push_back(roi);
+    }
+  }
+
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (std::size_t a = 0; a < rois.size() && !merged; ++a) {
+      for (std::size_t b = a + 1; b < rois.size(); ++b) {
+        if (!(rois[a] & rois[b]).empty()) {
+          rois[a] |= rois[b];
+          rois.erase(rois.begin() + static_cast<std::ptrdiff_t>(b));
+          merged = true;
+          break;
+        }
+      }
+    }
+  }
+  return rois;
+}
+
+struct BackendTargets {
+  int backend_id = 0;
+  int target_id = 0;
+};
+
+bool TargetAvailable(const cv::dnn::Backend backend, const cv::dnn::Target target)
+{
+  try {
+    const std::vector<cv::dnn::Target> targets = cv::dnn::getAvailableTargets(backend);
+    return std::find(targets.begin(), targets.end(), target) != targets.end();
+  } catch (...) {
+    return false;
+  }
+}
+
+InferenceWorker::DnnBackend ResolveAutoBackend()
+{
+  if (TargetAvailable(cv::dnn::DNN_BACKEND_CUDA, cv::dnn::DNN_TARGET_CUDA)) {
+    return InferenceWorker::DnnBackend::kCuda;
+  }
+  if (TargetAvailable(cv::dnn::DNN_BACKEND_OPENCV, cv::dnn::DNN_TARGET_OPENCL)) {
+    return InferenceWorker::DnnBackend::kOpenCl;
+  }
+  return InferenceWorker::DnnBackend::kCpu;
+}
+
+BackendTargets BackendIds(const InferenceWorker::DnnBackend backend)
+{
+  switch (backend) {
+  case InferenceWorker::DnnBackend::kOpenCl:
+    return {cv::dnn::DNN_BACKEND_OPENCV, cv::dnn::DNN_TARGET_OPENCL};
+  case InferenceWorker::DnnBackend::kOpenClFp16:
+    return {cv::dnn::DNN_BACKEND_OPENCV, cv::dnn::DNN_TARGET_OPENCL_FP16};
+  case InferenceWorker::DnnBackend::kCuda:
+    return {cv::dnn::DNN_BACKEND_CUDA, cv::dnn::DNN_TARGET_CUDA};
+  case InferenceWorker::DnnBackend::kAuto:
+  case InferenceWorker::DnnBackend::kCpu:
+  default:
+    return {cv::dnn::DNN_BACKEND_OPENCV, cv::dnn::DNN_TARGET_CPU};
+  }
+}
+
+// OpenCV caches compiled OpenCL programs on disk keyed by source hash and
+// device; pointing the cache at the module config directory persists them
+// across sessions so accelerated backends skip recompilation. Compiled CPU
+// graphs have no equivalent serialization, which is what the warmup pass in
+// WarmUpNetworks hides instead.
+void ApplyKernelCacheDir(const std::string &cache_dir)
+{
+  static std::once_flag applied;
+  std::call_once(applied, [&cache_dir] {
+#ifdef _WIN32
+    _putenv_s("OPENCV_OPENCL_CACHE_DIR", cache_dir.c_str());
+#else
+    setenv("OPENCV_OPENCL_CACHE_DIR", cache_dir.c_str(), 0);
+#endif
+  });
+}
+
+const char *BackendName(const InferenceWorker::DnnBackend backend)
+{
+  switch (backend) {
+  case InferenceWorker::DnnBackend::kAuto:
+    return "auto";
+  case InferenceWorker::DnnBackend::kOpenCl:
+    return "OpenCL";
+  case InferenceWorker::DnnBackend::kOpenClFp16:
+    return "OpenCL-FP16";
+  case InferenceWorker::DnnBackend::kCuda:
+    return "CUDA";
+  case InferenceWorker::DnnBackend::kCpu:
+  default:
+    return "CPU";
+  }
+}
+
+bool LooksLikeProbabilities(const std::array<float, kEmotionClassCount> &values)
+{
+  float sum = 0.0f;
+  for (const float value : values) {
+    if (!std::isfinite(value)) {
+      return false;
+    }
+    if (value < -0.001f || value > 1.001f) {
+      return false;
+    }
+    sum += value;
+  }
+  return sum > 0.85f && sum < 1.15f;
+}
+
+std::array<float, kEmotionClassCount> NormalizeEmotionOutput(const std::array<float, kEmotionClassCount> &model_output)
+{
+  std::array<float, kEmotionClassCount> probs {};
+
+  if (LooksLikeProbabilities(model_output)) {
+    float sum = 0.0f;
+    for (std::size_t i = 0; i < kEmotionClassCount; ++i) {
+      probs[i] = std::clamp(model_output[i], 0.0f, 1.0f);
+      sum += probs[i];
+    }
+
+    if (sum > std::numeric_limits<float>::epsilon()) {
+      for (float &value : probs) {
+        value /= sum;
+      }
+      return probs;
+    }
+  }
+
+  const float max_logit = *std::max_element(model_output.begin(), model_output.end());
+
+  float sum = 0.0f;
+  for (std::size_t i = 0; i < kEmotionClassCount; ++i) {
+    probs[i] = std::exp(model_output[i] - max_logit);
+    sum += probs[i];
+  }
+
+  if (sum <= std::numeric_limits<float>::epsilon()) {
+    probs.fill(1.0f / static_cast<float>(kEmotionClassCount));
+    return probs;
+  }
+
+  for (float &value : probs) {
+    value /= sum;
+  }
+
+  return probs;
+}
+
 } // namespace
 
 InferenceWorker::InferenceWorker() = default;
@@ -57,44 +268,46 @@ bool InferenceWorker::Start(
 {
   Stop();
 
-  try {
-    face_detector_ = cv::FaceDetectorYN::create(face_model_path, "", cv::Size(320, 320), 0.7f, 0.3f, 5000);
-    emotion_net_ = cv::dnn::readNetFromONNX(emotion_model_path);
-    if (face_detector_.empty()) {
-      if (error != nullptr) {
-        *error = "Face detector initialization failed.";
-      }
-      return false;
-    }
-    if (emotion_net_.empty()) {
-      if (error != nullptr) {
-        *error = "Emotion model initialization failed.";
-      }
-      return false;
-    }
-  } catch (const std::exception &ex) {
+  if (face_model_path.empty() || emotion_model_path.empty()) {
     if (error != nullptr) {
-      *error = ex.what();
+      *error = "Model paths are empty.";
     }
     return false;
   }
 
+  stop_requested_.store(false, std::memory_order_relaxed);
   {
-    std::scoped_lock lock(config_mutex_);
-    config_ = config;
-  }
-  {
-    std::scoped_lock queue_lock(queue_mutex_);
-    queue_.clear();
-    stop_requested_ = false;
+    std::scoped_lock lock(state_mutex_);
+    for (auto &[client_id, client] : clients_) {
+      client->pending = {};
+      client->has_pending = false;
+    }
   }
   {
-    std::scoped_lock result_lock(result_mutex_);
-    latest_result_ = {};
+    std::scoped_lock pool_lock(pool_mutex_);
+    frame_pool_.clear();
   }
-  tracker_.Reset();
+  handoff_ = {};
+  blob_pool_.clear();
 
-  worker_thread_ = std::thread(&InferenceWorker::WorkerLoop, this);
+  face_model_path_ = face_model_path;
+  emotion_model_path_ = emotion_model_path;
+  cache_dir_ = config.cache_dir;
+  requested_backend_ = config.backend;
+  low_priority_ = config.low_priority;
+  affinity_mask_ = config.affinity_mask;
+  opencv_threads_ = config.opencv_threads;
+  fixed_detector_input_ = config.fixed_detector_input;
+  detector_input_size_ = std::max(320, config.inference_width);
+  scratch_letterbox_.release();
+  letterbox_content_size_ = cv::Size(0, 0);
+  models_ready_.store(false, std::memory_order_release);
+
+  // Model parsing happens on the detect thread so filter creation and
+  // scene-collection switches never stall the caller; frames submitted before
+  // the networks are ready are simply dropped.
+  detect_thread_ = std::thread(&InferenceWorker::DetectLoop, this);
+  emotion_thread_ = std::thread(&InferenceWorker::EmotionLoop, this);
   running_ = true;
   return true;
 }
@@ -102,82 +315,233 @@ bool InferenceWorker::Start(
 void InferenceWorker::Stop()
 {
   {
-    std::scoped_lock lock(queue_mutex_);
-    stop_requested_ = true;
+    std::scoped_lock lock(state_mutex_);
+    stop_requested_.store(true, std::memory_order_release);
   }
   queue_cv_.notify_all();
+  {
+    // Taken and dropped so a stage thread between its predicate check and its
+    // wait cannot miss the notify below.
+    std::scoped_lock lock(handoff_mutex_);
+  }
+  handoff_cv_.notify_all();
 
-  if (worker_thread_.joinable()) {
-    worker_thread_.join();
+  if (detect_thread_.joinable()) {
+    detect_thread_.join();
+  }
+  if (emotion_thread_.joinable()) {
+    emotion_thread_.join();
   }
 
+  stop_requested_.store(false, std::memory_order_relaxed);
   {
-    std::scoped_lock lock(queue_mutex_);
-    queue_.clear();
-    stop_requested_ = false;
+    std::scoped_lock lock(state_mutex_);
+    for (auto &[client_id, client] : clients_) {
+      client->pending = {};
+      client->has_pending = false;
+    }
   }
   {
-    std::scoped_lock result_lock(result_mutex_);
-    latest_result_ = {};
+    std::scoped_lock pool_lock(pool_mutex_);
+    frame_pool_.clear();
   }
+  handoff_ = {};
+  blob_pool_.clear();
   running_ = false;
-  tracker_.Reset();
+  models_ready_.store(false, std::memory_order_release);
+}
+
+InferenceWorker::ClientId InferenceWorker::RegisterClient(const Config &config)
+{
+  auto client = std::make_shared<ClientState>();
+  client->config = std::make_shared<const Config>(config);
+
+  std::scoped_lock lock(state_mutex_);
+  const ClientId client_id = next_client_id_++;
+  clients_.emplace(client_id, std::move(client));
+  return client_id;
+}
+
+void InferenceWorker::UnregisterClient(const ClientId client_id)
+{
+  std::scoped_lock lock(state_mutex_);
+  clients_.erase(client_id);
 }
 
-void InferenceWorker::UpdateConfig(const Config &config)
+void InferenceWorker::UpdateClientConfig(const ClientId client_id, const Config &config)
 {
-  std::scoped_lock lock(config_mutex_);
-  config_ = config;
+  std::scoped_lock lock(state_mutex_);
+  const auto found = clients_.find(client_id);
+  if (found != clients_.end()) {
+    found->second->config = std::make_shared<const Config>(config);
+  }
 }
 
-void InferenceWorker::SubmitFrame(const cv::Mat &bgr_frame, const uint64_t timestamp_ns, const int source_width, const int source_height)
+void InferenceWorker::SubmitFrame(
+  const ClientId client_id,
+  const cv::Mat &image,
+  const uint64_t timestamp_ns,
+  const int source_width,
+  const int source_height)
 {
-  if (!running_ || bgr_frame.empty()) {
+  if (!running_ || !IsReady() || image.empty()) {
     return;
   }
 
   FrameTask task;
-  task.bgr_frame = bgr_frame.clone();
+  task.image = AcquireFrameBuffer(image.rows, image.cols, image.type());
+  image.copyTo(task.image);
   task.timestamp_ns = timestamp_ns;
   task.source_width = source_width;
   task.source_height = source_height;
+  task.enqueued_at = std::chrono::steady_clock::now();
 
   {
-    std::scoped_lock lock(queue_mutex_);
-    if (queue_.size() >= kMaxQueueSize) {
-      queue_.pop_front();
+    std::scoped_lock lock(state_mutex_);
+    const auto found = clients_.find(client_id);
+    if (found == clients_.end()) {
+      ReleaseFrameBuffer(std::move(task.image));
+      return;
+    }
+
+    // Latest-wins per client: an unprocessed older frame is recycled.
+    ClientState &client = *found->second;
+    if (client.has_pending) {
+      ReleaseFrameBuffer(std::move(client.pending.image));
     }
-    queue_.push_back(std::move(task));
+    client.pending = std::move(task);
+    client.has_pending = true;
   }
 
   queue_cv_.notify_one();
 }
 
-bool InferenceWorker::TryConsumeLatest(std::vector<DetectedFace> *faces, double *inference_ms, uint64_t *timestamp_ns)
+cv::Mat InferenceWorker::AcquireFrameBuffer(const int rows, const int cols, const int type)
+{
+  {
+    std::scoped_lock lock(pool_mutex_);
+    while (!frame_pool_.empty()) {
+      cv::Mat buffer = std::move(frame_pool_.back());
+      frame_pool_.pop_back();
+      // Buffers from before a resolution change are discarded; the pool refills at the new size.
+      if (buffer.rows == rows && buffer.cols == cols && buffer.type() == type && buffer.isContinuous()) {
+        return buffer;
+      }
+    }
+  }
+
+  return cv::Mat(rows, cols, type);
+}
+
+void InferenceWorker::ReleaseFrameBuffer(cv::Mat &&buffer)
 {
-  std::scoped_lock lock(result_mutex_);
-  if (!latest_result_.valid) {
+  if (buffer.empty()) {
+    return;
+  }
+
+  std::scoped_lock lock(pool_mutex_);
+  if (frame_pool_.size() < kFramePoolCapacity) {
+    frame_pool_.push_back(std::move(buffer));
+  }
+}
+
+cv::Mat InferenceWorker::AcquireEmotionBlob()
+{
+  // Batch blobs ping-pong between the stages: one being filled on the detect
+  // thread while the other feeds the emotion net. create() in FillEmotionBlob
+  // reuses the storage whenever the face count is stable.
+  std::scoped_lock lock(handoff_mutex_);
+  if (blob_pool_.empty()) {
+    return {};
+  }
+  cv::Mat blob = std::move(blob_pool_.back());
+  blob_pool_.pop_back();
+  return blob;
+}
+
+void InferenceWorker::ReleaseEmotionBlob(cv::Mat &&blob)
+{
+  if (blob.empty()) {
+    return;
+  }
+
+  std::scoped_lock lock(handoff_mutex_);
+  if (blob_pool_.size() < 2) {
+    blob_pool_.push_back(std::move(blob));
+  }
+}
+
+bool InferenceWorker::TryConsumeLatest(
+  const ClientId client_id,
+  std::vector<DetectedFace> *faces,
+  double *inference_ms,
+  uint64_t *timestamp_ns)
+{
+  std::shared_ptr<ClientState> client;
+  {
+    std::scoped_lock lock(state_mutex_);
+    const auto found = clients_.find(client_id);
+    if (found == clients_.end()) {
+      return false;
+    }
+    client = found->second;
+  }
+
+  if ((client->shared_index.load(std::memory_order_acquire) & ClientState::kFreshBit) == 0) {
+    return false;
+  }
+
+  // Only the consumer clears the freshness bit, so once observed it stays set
+  // until this exchange; the worker may meanwhile publish an even newer slot,
+  // which is exactly the one we want.
+  const uint32_t previous = client->shared_index.exchange(client->read_index, std::memory_order_acq_rel);
+  client->read_index = previous & ClientState::kSlotMask;
+  ResultPacket &slot = client->result_slots[client->read_index];
+  if (!slot.valid) {
     return false;
   }
 
   if (faces != nullptr) {
-    *faces = latest_result_.faces;
+    faces->swap(slot.faces);
   }
   if (inference_ms != nullptr) {
-    *inference_ms = latest_result_.inference_ms;
+    *inference_ms = slot.inference_ms;
   }
   if (timestamp_ns != nullptr) {
-    *timestamp_ns = latest_result_.timestamp_ns;
+    *timestamp_ns = slot.timestamp_ns;
   }
 
-  latest_result_.valid = false;
+  slot.valid = false;
   return true;
 }
 
+int InferenceWorker::EffectiveInferenceWidth(const ClientId client_id) const
+{
+  std::scoped_lock lock(state_mutex_);
+  const auto found = clients_.find(client_id);
+  if (found == clients_.end()) {
+    return 0;
+  }
+
+  const int width = found->second->effective_width.load(std::memory_order_relaxed);
+  return width > 0 ? width : found->second->config->inference_width;
+}
+
+const StageLatencyStats &InferenceWorker::Stats() const
+{
+  return stage_stats_;
+}
+
 std::size_t InferenceWorker::QueueSize() const
 {
-  std::scoped_lock lock(queue_mutex_);
-  return queue_.size();
+  std::scoped_lock lock(state_mutex_);
+  std::size_t pending = 0;
+  for (const auto &[client_id, client] : clients_) {
+    if (client->has_pending) {
+      ++pending;
+    }
+  }
+  return pending;
 }
 
 bool InferenceWorker::IsRunning() const
@@ -185,68 +549,485 @@ bool InferenceWorker::IsRunning() const
   return running_.load();
 }
 
-void InferenceWorker::WorkerLoop()
+bool InferenceWorker::IsReady() const
+{
+  return models_ready_.load(std::memory_order_acquire);
+}
+
+std::shared_ptr<InferenceWorker::ClientState> InferenceWorker::NextPendingClientLocked(FrameTask *task)
+{
+  // Round-robin over clients so one busy source cannot starve the others.
+  auto it = clients_.upper_bound(last_served_client_);
+  for (std::size_t step = 0; step <= clients_.size(); ++step, ++it) {
+    if (it == clients_.end()) {
+      it = clients_.begin();
+    }
+    if (it == clients_.end()) {
+      break;
+    }
+    if (it->second->has_pending) {
+      last_served_client_ = it->first;
+      *task = std::move(it->second->pending);
+      it->second->pending = {};
+      it->second->has_pending = false;
+      return it->second;
+    }
+  }
+  return nullptr;
+}
+
+void InferenceWorker::ApplySchedulingControls(const bool log_summary)
 {
+  // OpenCV creates its pool lazily, so capping it before the first forward
+  // keeps the DNN from ever spinning up more threads than allowed. The pool
+  // is process-global; scoping any tighter than that is not possible.
+  if (opencv_threads_ > 0) {
+    cv::setNumThreads(opencv_threads_);
+  }
+
+#if defined(_WIN32)
+  if (low_priority_) {
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+  }
+  if (affinity_mask_ != 0 && SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(affinity_mask_)) == 0) {
+    obs_log(LOG_WARNING, "failed to apply inference affinity mask 0x%llx", static_cast<unsigned long long>(affinity_mask_));
+  }
+#elif defined(__APPLE__)
+  if (low_priority_) {
+    pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0);
+  }
+  if (affinity_mask_ != 0) {
+    // macOS offers no thread-to-core pinning; the QoS class above is the
+    // supported way to steer work onto the efficiency cores.
+    obs_log(LOG_WARNING, "CPU affinity is not supported on macOS; mask ignored");
+  }
+#else
+  if (low_priority_) {
+    // Niceness is per-thread on Linux when addressed by tid.
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+  }
+  if (affinity_mask_ != 0) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int cpu = 0; cpu < 64; ++cpu) {
+      if ((affinity_mask_ >> cpu) & 1ULL) {
+        CPU_SET(cpu, &cpu_set);
+      }
+    }
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) != 0) {
+      obs_log(LOG_WARNING, "failed to apply inference affinity mask 0x%llx", static_cast<unsigned long long>(affinity_mask_));
+    }
+  }
+#endif
+
+  if (log_summary && (low_priority_ || affinity_mask_ != 0 || opencv_threads_ > 0)) {
+    obs_log(
+      LOG_INFO,
+      "inference worker scheduling: low_priority=%d affinity=0x%llx opencv_threads=%d",
+      low_priority_ ? 1 : 0,
+      static_cast<unsigned long long>(affinity_mask_),
+      opencv_threads_);
+  }
+}
+
+void InferenceWorker::DetectLoop()
+{
+  ApplySchedulingControls(true);
+  if (!LoadNetworks()) {
+    running_ = false;
+    return;
+  }
+  // Graph initialization happens on the first forward; pay it here so neither
+  // the first real frame nor the perf log sees a multi-hundred-ms spike. The
+  // emotion warmup runs on this thread too, which is safe because the emotion
+  // thread never touches the net before the first batch reaches it.
+  WarmUpNetworks();
+  models_ready_.store(true, std::memory_order_release);
+
   for (;;) {
+    std::shared_ptr<ClientState> client;
+    std::shared_ptr<const Config> config;
     FrameTask task;
+    std::vector<cv::Rect> track_boxes;
     {
-      std::unique_lock lock(queue_mutex_);
-      queue_cv_.wait(lock, [this] { return stop_requested_ || !queue_.empty(); });
+      std::unique_lock lock(state_mutex_);
+      queue_cv_.wait(lock, [this] {
+        if (stop_requested_.load(std::memory_order_relaxed)) {
+          return true;
+        }
+        for (const auto &[client_id, state] : clients_) {
+          if (state->has_pending) {
+            return true;
+          }
+        }
+        return false;
+      });
 
-      if (stop_requested_ && queue_.empty()) {
+      if (stop_requested_.load(std::memory_order_relaxed)) {
         break;
       }
 
-      task = std::move(queue_.front());
-      queue_.pop_front();
+      client = NextPendingClientLocked(&task);
+      if (client == nullptr) {
+        continue;
+      }
+      config = client->config;
+      track_boxes = client->last_track_boxes;
     }
 
+    // Queue wait covers SubmitFrame to here: the latest-wins slot plus any
+    // time spent behind other clients' frames.
+    stage_stats_.queue_wait.Record(MillisecondsSince(task.enqueued_at));
+
     const auto started = std::chrono::steady_clock::now();
-    std::vector<DetectedFace> detections = RunInference(task);
-    const auto ended = std::chrono::steady_clock::now();
-    const double inference_ms =
-      std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(ended - started).count();
+    DetectBatch batch = RunDetection(client.get(), *config, task, track_boxes);
+    batch.client = std::move(client);
+    batch.config = std::move(config);
+    batch.timestamp_ns = task.timestamp_ns;
+    batch.detect_stage_ms = MillisecondsSince(started);
+    batch.valid = true;
+
+    // The blob owns the preprocessed crops by now, so the task frame can go
+    // back to the pool before the emotion stage runs.
+    ReleaseFrameBuffer(std::move(task.image));
+
+    // Single-slot handoff: block until the emotion stage drained the previous
+    // frame. Input overload keeps being absorbed upstream by the latest-wins
+    // pending slots, so waiting here never grows a backlog.
+    {
+      std::unique_lock lock(handoff_mutex_);
+      handoff_cv_.wait(lock, [this] { return !handoff_.valid || stop_requested_.load(std::memory_order_relaxed); });
+      if (stop_requested_.load(std::memory_order_relaxed)) {
+        break;
+      }
+      handoff_ = std::move(batch);
+    }
+    handoff_cv_.notify_all();
+  }
+}
+
+void InferenceWorker::EmotionLoop()
+{
+  ApplySchedulingControls(false);
+
+  for (;;) {
+    DetectBatch batch;
+    {
+      std::unique_lock lock(handoff_mutex_);
+      handoff_cv_.wait(lock, [this] { return handoff_.valid || stop_requested_.load(std::memory_order_relaxed); });
+      if (stop_requested_.load(std::memory_order_relaxed)) {
+        break;
+      }
+      batch = std::move(handoff_);
+      handoff_ = {};
+    }
+    handoff_cv_.notify_all();
+
+    const auto stage_started = std::chrono::steady_clock::now();
+    ClientState *client = batch.client.get();
+
+    if (batch.reset_tracker) {
+      client->tracker.Reset();
+      std::scoped_lock lock(state_mutex_);
+      client->last_track_boxes.clear();
+    }
+
+    std::vector<std::array<float, kEmotionClassCount>> batch_output;
+    if (!batch.detections.empty()) {
+      const auto emotion_started = std::chrono::steady_clock::now();
+      try {
+        batch_output = ForwardEmotionBlob(batch.emotion_blob, batch.detections.size());
+      } catch (...) {
+        // This stage only ever falls back for itself; the detector keeps its
+        // backend and handles its own failures on the detect thread.
+        obs_log(LOG_WARNING, "emotion inference failed; moving the emotion net to the CPU");
+        emotion_net_.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+        emotion_net_.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+        batch.detections.clear();
+        client->tracker.Reset();
+        std::scoped_lock lock(state_mutex_);
+        client->last_track_boxes.clear();
+      }
+      // The blob fill happened on the detect thread but belongs to this
+      // stage's cost, so fold it into the same histogram sample.
+      stage_stats_.emotion.Record(batch.blob_fill_ms + MillisecondsSince(emotion_started));
+      for (std::size_t i = 0; i < batch.detections.size() && i < batch_output.size(); ++i) {
+        batch.detections[i].probs_raw = batch_output[i];
+      }
+    }
+
+    const auto tracker_started = std::chrono::steady_clock::now();
+    std::vector<DetectedFace> tracked = client->tracker.Update(
+      batch.detections,
+      batch.timestamp_ns,
+      batch.config->max_faces,
+      batch.config->smoothing_seconds,
+      batch.config->confidence_threshold);
+    stage_stats_.tracker.Record(MillisecondsSince(tracker_started));
+
+    {
+      // Coasted tracks stay in the ROI schedule so a briefly missed face is
+      // looked for where it went, not only on the next full sweep.
+      std::scoped_lock lock(state_mutex_);
+      client->last_track_boxes.clear();
+      for (const DetectedFace &face : tracked) {
+        client->last_track_boxes.push_back(face.bbox);
+      }
+    }
+
+    // Per-frame inference cost excludes the handoff wait: it is the work both
+    // stages spent on this frame, which is what the adaptive-width controller
+    // budgets against.
+    const double inference_ms = batch.detect_stage_ms + MillisecondsSince(stage_started);
+    UpdateAdaptiveWidth(client, *batch.config, inference_ms);
 
     ResultPacket result;
-    result.faces = std::move(detections);
+    result.faces = std::move(tracked);
     result.inference_ms = inference_ms;
-    result.timestamp_ns = task.timestamp_ns;
+    result.timestamp_ns = batch.timestamp_ns;
     result.valid = true;
+    PublishResult(client, std::move(result));
 
-    {
-      std::scoped_lock lock(result_mutex_);
-      latest_result_ = std::move(result);
+    ReleaseEmotionBlob(std::move(batch.emotion_blob));
+  }
+}
+
+void InferenceWorker::UpdateAdaptiveWidth(ClientState *client, const Config &config, const double inference_ms)
+{
+  if (!config.adaptive_width || config.target_latency_ms <= 0.0f) {
+    client->effective_width.store(config.inference_width, std::memory_order_relaxed);
+    client->latency_ema_ms = 0.0;
+    client->results_since_adjust = 0;
+    return;
+  }
+
+  client->latency_ema_ms = client->latency_ema_ms <= 0.0
+    ? inference_ms
+    : (1.0 - kAdaptiveEmaWeight) * client->latency_ema_ms + kAdaptiveEmaWeight * inference_ms;
+
+  int width = client->effective_width.load(std::memory_order_relaxed);
+  if (width <= 0) {
+    width = config.inference_width;
+    client->effective_width.store(width, std::memory_order_relaxed);
+  }
+
+  if (++client->results_since_adjust < kAdaptiveAdjustInterval) {
+    return;
+  }
+  client->results_since_adjust = 0;
+
+  const double budget = static_cast<double>(config.target_latency_ms);
+  int updated = width;
+  if (client->latency_ema_ms > budget * kAdaptiveOverBudgetRatio) {
+    updated = width - kAdaptiveWidthStep;
+  } else if (client->latency_ema_ms < budget * kAdaptiveUnderBudgetRatio) {
+    updated = width + kAdaptiveWidthStep;
+  }
+  updated = std::clamp(updated, std::min(kAdaptiveWidthFloor, config.inference_width), config.inference_width);
+
+  if (updated != width) {
+    client->effective_width.store(updated, std::memory_order_relaxed);
+    obs_log(LOG_DEBUG, "adaptive inference width %d -> %d (avg %.1f ms, budget %.1f ms)",
+            width, updated, client->latency_ema_ms, budget);
+  }
+}
+
+void InferenceWorker::PublishResult(ClientState *client, ResultPacket &&result)
+{
+  client->result_slots[client->write_index] = std::move(result);
+  const uint32_t previous =
+    client->shared_index.exchange(client->write_index | ClientState::kFreshBit, std::memory_order_acq_rel);
+  client->write_index = previous & ClientState::kSlotMask;
+}
+
+bool InferenceWorker::LoadNetworks()
+{
+  const DnnBackend resolved_backend =
+    requested_backend_ == DnnBackend::kAuto ? ResolveAutoBackend() : requested_backend_;
+  const BackendTargets ids = BackendIds(resolved_backend);
+
+  if (!cache_dir_.empty()) {
+    ApplyKernelCacheDir(cache_dir_);
+  }
+
+  try {
+    face_detector_ = cv::FaceDetectorYN::create(
+      face_model_path_, "", cv::Size(320, 320), 0.7f, 0.3f, 5000, ids.backend_id, ids.target_id);
+    emotion_net_ = cv::dnn::readNetFromONNX(emotion_model_path_);
+    emotion_net_.setPreferableBackend(ids.backend_id);
+    emotion_net_.setPreferableTarget(ids.target_id);
+    if (face_detector_.empty() || emotion_net_.empty()) {
+      obs_log(LOG_ERROR, "model initialization failed; inference stays disabled");
+      return false;
+    }
+    if (fixed_detector_input_) {
+      // Set once; RunDetection never reconfigures the detector afterwards, so
+      // its prior/anchor state stays static across frames and sources.
+      face_detector_->setInputSize(cv::Size(detector_input_size_, detector_input_size_));
     }
+  } catch (const std::exception &ex) {
+    obs_log(LOG_ERROR, "model loading failed: %s", ex.what());
+    return false;
   }
+
+  active_backend_ = resolved_backend;
+  obs_log(LOG_INFO, "inference worker using %s backend", BackendName(resolved_backend));
+  return true;
 }
 
-std::vector<DetectedFace> InferenceWorker::RunInference(const FrameTask &task)
+void InferenceWorker::WarmUpNetworks()
 {
-  Config config;
-  {
-    std::scoped_lock lock(config_mutex_);
-    config = config_;
+  const auto started = std::chrono::steady_clock::now();
+  try {
+    const int warmup_side = fixed_detector_input_ ? detector_input_size_ : 320;
+    cv::Mat dummy_frame(warmup_side, warmup_side, CV_8UC3, cv::Scalar(0, 0, 0));
+    if (!fixed_detector_input_) {
+      face_detector_->setInputSize(dummy_frame.size());
+    }
+    cv::Mat face_matrix;
+    face_detector_->detect(dummy_frame, face_matrix);
+    cv::Mat warmup_blob = AcquireEmotionBlob();
+    FillEmotionBlob({cv::Mat(kEmotionInputSize, kEmotionInputSize, CV_8UC3, cv::Scalar(0, 0, 0))}, &warmup_blob);
+    ForwardEmotionBlob(warmup_blob, 1);
+    ReleaseEmotionBlob(std::move(warmup_blob));
+  } catch (...) {
+    // Warmup failures are not fatal; the first real frame pays the cost instead.
   }
+  const auto ended = std::chrono::steady_clock::now();
+  const double warmup_ms =
+    std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(ended - started).count();
+  obs_log(LOG_INFO, "network warmup took %.1f ms", warmup_ms);
+}
 
-  if (task.bgr_frame.empty()) {
-    tracker_.Reset();
-    return {};
+bool InferenceWorker::FallBackDetectorToCpu()
+{
+  obs_log(LOG_WARNING, "detection failed on %s backend; falling back to CPU", BackendName(active_backend_));
+
+  try {
+    face_detector_ = cv::FaceDetectorYN::create(
+      face_model_path_, "", cv::Size(320, 320), 0.7f, 0.3f, 5000, cv::dnn::DNN_BACKEND_OPENCV,
+      cv::dnn::DNN_TARGET_CPU);
+    if (fixed_detector_input_) {
+      face_detector_->setInputSize(cv::Size(detector_input_size_, detector_input_size_));
+    }
+  } catch (const std::exception &ex) {
+    obs_log(LOG_ERROR, "CPU fallback failed: %s", ex.what());
+    return false;
+  }
+
+  active_backend_ = DnnBackend::kCpu;
+  return true;
+}
+
+cv::Mat InferenceWorker::LetterboxDetectorInput(const cv::Mat &frame, cv::Point2d *scale)
+{
+  const int side = detector_input_size_;
+  if (scratch_letterbox_.rows != side || scratch_letterbox_.cols != side ||
+      scratch_letterbox_.type() != frame.type()) {
+    scratch_letterbox_ = cv::Mat(side, side, frame.type(), cv::Scalar::all(0));
+    letterbox_content_size_ = cv::Size(0, 0);
+  }
+
+  // Fit without upscaling; padding carries no information the detector needs.
+  const double fit =
+    std::min(1.0, std::min(static_cast<double>(side) / frame.cols, static_cast<double>(side) / frame.rows));
+  const cv::Size content(
+    std::max(1, static_cast<int>(std::round(frame.cols * fit))),
+    std::max(1, static_cast<int>(std::round(frame.rows * fit))));
+  scale->x = static_cast<double>(content.width) / frame.cols;
+  scale->y = static_cast<double>(content.height) / frame.rows;
+
+  // Content anchors top-left so mapping back is a pure division; when the
+  // content shrinks (adaptive width, aspect change) the exposed border is
+  // re-zeroed once instead of clearing the whole canvas every frame.
+  if (content != letterbox_content_size_) {
+    scratch_letterbox_.setTo(cv::Scalar::all(0));
+    letterbox_content_size_ = content;
+  }
+
+  cv::Mat roi = scratch_letterbox_(cv::Rect(0, 0, content.width, content.height));
+  if (content == frame.size()) {
+    frame.copyTo(roi);
+  } else {
+    cv::resize(frame, roi, content, 0.0, 0.0, cv::INTER_LINEAR);
+  }
+  return scratch_letterbox_;
+}
+
+InferenceWorker::DetectBatch InferenceWorker::RunDetection(
+  ClientState *client, const Config &config, const FrameTask &task, const std::vector<cv::Rect> &track_boxes)
+{
+  DetectBatch batch;
+  if (task.image.empty()) {
+    batch.reset_tracker = true;
+    return batch;
+  }
+
+  // The submit path already fused color conversion and downscale, so the task
+  // frame normally arrives at inference resolution; the resize below only
+  // triggers when the target width shrank after the frame was submitted
+  // (config change or an adaptive step down).
+  int target_width = config.inference_width;
+  if (config.adaptive_width) {
+    const int effective = client->effective_width.load(std::memory_order_relaxed);
+    if (effective > 0) {
+      target_width = std::min(effective, config.inference_width);
+    }
+  }
+
+  cv::Mat inference_frame = task.image;
+  if (target_width > 0 && task.image.cols > target_width) {
+    const double shrink = static_cast<double>(target_width) / static_cast<double>(task.image.cols);
+    const int resized_height = std::max(1, static_cast<int>(std::round(task.image.rows * shrink)));
+    cv::resize(task.image, inference_frame, cv::Size(target_width, resized_height), 0.0, 0.0, cv::INTER_LINEAR);
+  }
+
+  // Grayscale submissions carry one channel; the detector wants three, so
+  // replicate once at inference resolution. The emotion crops keep reading
+  // the single-channel frame and skip their own gray conversion entirely.
+  cv::Mat emotion_source = inference_frame;
+  if (inference_frame.channels() == 1) {
+    cv::cvtColor(inference_frame, scratch_detector_input_, cv::COLOR_GRAY2BGR);
+    inference_frame = scratch_detector_input_;
+  }
+
+  // Detections come out in inference-frame coordinates and map back to source
+  // coordinates through the extraction scale.
+  const double map_x = static_cast<double>(task.source_width) / static_cast<double>(inference_frame.cols);
+  const double map_y = static_cast<double>(task.source_height) / static_cast<double>(inference_frame.rows);
+
+  // ROI passes scan only expanded neighborhoods of the last result's tracks;
+  // the periodic full sweep picks up new entrants. Anything without tracks to
+  // anchor on falls through to a full sweep.
+  std::vector<cv::Rect> roi_rects;
+  if (config.roi_detection && !track_boxes.empty() && client->last_full_sweep_ns != 0 &&
+      task.timestamp_ns >= client->last_full_sweep_ns) {
+    const auto sweep_interval_ns =
+      static_cast<uint64_t>(std::max(0.1f, config.full_sweep_interval_s) * 1.0e9f);
+    if (task.timestamp_ns - client->last_full_sweep_ns < sweep_interval_ns) {
+      roi_rects = BuildRoiRects(track_boxes, map_x, map_y, inference_frame.size());
+    }
   }
+  const bool roi_pass = !roi_rects.empty();
 
-  cv::Mat inference_frame = task.bgr_frame;
-  double scale = 1.0;
-  if (config.inference_width > 0 && task.bgr_frame.cols > config.inference_width) {
-    scale = static_cast<double>(config.inference_width) / static_cast<double>(task.bgr_frame.cols);
-    const int resized_height = std::max(1, static_cast<int>(std::round(task.bgr_frame.rows * scale)));
-    cv::resize(task.bgr_frame, inference_frame, cv::Size(config.inference_width, resized_height), 0.0, 0.0, cv::INTER_LINEAR);
+  // Fixed-input mode feeds a constant-sized letterbox canvas so the detector
+  // graph never reconfigures; otherwise the detector follows the frame size.
+  // ROI passes size the detector per crop either way.
+  cv::Mat detector_frame = inference_frame;
+  cv::Point2d letterbox_scale(1.0, 1.0);
+  if (fixed_detector_input_ && !roi_pass) {
+    detector_frame = LetterboxDetectorInput(inference_frame, &letterbox_scale);
   }
 
   std::vector<RawFaceDetection> detections;
+  std::vector<cv::Mat> emotion_crops;
   try {
-    face_detector_->setInputSize(inference_frame.size());
+    const auto detect_started = std::chrono::steady_clock::now();
     cv::Mat face_matrix;
-    const int face_count = face_detector_->detect(inference_frame, face_matrix);
-    if (face_count > 0 && !face_matrix.empty()) {
+
+    // Shared by both tiers: parses one detect() output whose canvas starts at
+    // origin within inference_frame, scaled by scale.
+    const auto collect_detections = [&](const cv::Point &origin, const cv::Point2d &scale) {
       for (int row = 0; row < face_matrix.rows; ++row) {
         if (face_matrix.cols < 15) {
           continue;
@@ -262,123 +1043,138 @@ std::vector<DetectedFace> InferenceWorker::RunInference(const FrameTask &task)
         const float width = face_matrix.at<float>(row, 2);
         const float height = face_matrix.at<float>(row, 3);
 
-        const int mapped_x = static_cast<int>(std::round(x / scale));
-        const int mapped_y = static_cast<int>(std::round(y / scale));
-        const int mapped_w = static_cast<int>(std::round(width / scale));
-        const int mapped_h = static_cast<int>(std::round(height / scale));
+        // Dividing by the canvas scale and adding the crop origin lands the
+        // detection back on inference_frame, whichever tier produced it.
+        cv::Rect detector_bbox(
+          static_cast<int>(std::round(x / scale.x)) + origin.x,
+          static_cast<int>(std::round(y / scale.y)) + origin.y,
+          static_cast<int>(std::round(width / scale.x)),
+          static_cast<int>(std::round(height / scale.y)));
+        detector_bbox = ClampRectToFrame(detector_bbox, inference_frame.cols, inference_frame.rows);
+        if (detector_bbox.empty()) {
+          continue;
+        }
+
+        const int mapped_x = static_cast<int>(std::round(detector_bbox.x * map_x));
+        const int mapped_y = static_cast<int>(std::round(detector_bbox.y * map_y));
+        const int mapped_w = static_cast<int>(std::round(detector_bbox.width * map_x));
+        const int mapped_h = static_cast<int>(std::round(detector_bbox.height * map_y));
         cv::Rect bbox(mapped_x, mapped_y, mapped_w, mapped_h);
         bbox = ClampRectToFrame(bbox, task.source_width, task.source_height);
         if (bbox.empty()) {
           continue;
         }
 
-        const cv::Rect emotion_roi = MakeSquareRect(bbox, task.source_width, task.source_height);
-        const auto probabilities = InferEmotion(task.bgr_frame(emotion_roi));
-        detections.push_back(RawFaceDetection {bbox, probabilities});
+        // The emotion crop comes straight from the inference frame; the 64x64
+        // network input never benefits from full-resolution pixels.
+        const cv::Rect emotion_roi = MakeSquareRect(detector_bbox, inference_frame.cols, inference_frame.rows);
+        emotion_crops.push_back(emotion_source(emotion_roi));
+        detections.push_back(RawFaceDetection {bbox, {}});
+      }
+    };
+
+    if (roi_pass) {
+      for (const cv::Rect &roi : roi_rects) {
+        const cv::Mat crop = detector_frame(roi);
+        face_detector_->setInputSize(crop.size());
+        if (face_detector_->detect(crop, face_matrix) > 0 && !face_matrix.empty()) {
+          collect_detections(roi.tl(), cv::Point2d(1.0, 1.0));
+        }
+      }
+      if (fixed_detector_input_) {
+        // Restore the static input so the next full sweep needs no resize.
+        face_detector_->setInputSize(cv::Size(detector_input_size_, detector_input_size_));
       }
+    } else {
+      if (!fixed_detector_input_) {
+        face_detector_->setInputSize(detector_frame.size());
+      }
+      if (face_detector_->detect(detector_frame, face_matrix) > 0 && !face_matrix.empty()) {
+        collect_detections(cv::Point(0, 0), letterbox_scale);
+      }
+      client->last_full_sweep_ns = task.timestamp_ns;
     }
+    stage_stats_.detect.Record(MillisecondsSince(detect_started));
+
+    // The crops still alias this thread's scratch buffers, so they are
+    // preprocessed into the batch blob here, before the next frame can
+    // overwrite them; the emotion stage then works off the blob alone.
+    const auto fill_started = std::chrono::steady_clock::now();
+    batch.emotion_blob = AcquireEmotionBlob();
+    FillEmotionBlob(emotion_crops, &batch.emotion_blob);
+    batch.blob_fill_ms = MillisecondsSince(fill_started);
   } catch (...) {
-    tracker_.Reset();
-    return {};
+    batch.reset_tracker = true;
+    if (active_backend_ != DnnBackend::kCpu) {
+      FallBackDetectorToCpu();
+    }
+    return batch;
   }
 
-  return tracker_.Update(
-    detections,
-    task.timestamp_ns,
-    config.max_faces,
-    config.smoothing_seconds,
-    config.confidence_threshold);
+  batch.detections = std::move(detections);
+  return batch;
 }
 
-std::array<float, kEmotionClassCount> InferenceWorker::InferEmotion(const cv::Mat &face_bgr)
+void InferenceWorker::FillEmotionBlob(const std::vector<cv::Mat> &faces_bgr, cv::Mat *blob)
 {
-  std::array<float, kEmotionClassCount> model_output {};
-  if (face_bgr.empty()) {
-    return model_output;
-  }
-
-  cv::Mat gray_face;
-  cv::cvtColor(face_bgr, gray_face, cv::COLOR_BGR2GRAY);
-  cv::resize(gray_face, gray_face, cv::Size(kEmotionInputSize, kEmotionInputSize), 0.0, 0.0, cv::INTER_LINEAR);
-  cv::equalizeHist(gray_face, gray_face);
-
-  cv::Mat gray_float;
-  gray_face.convertTo(gray_float, CV_32F);
-  const cv::Mat blob = cv::dnn::blobFromImage(
-    gray_float,
-    1.0,
-    cv::Size(kEmotionInputSize, kEmotionInputSize),
-    cv::Scalar(),
-    false,
-    false,
-    CV_32F);
-
-  emotion_net_.setInput(blob);
-  const cv::Mat output = emotion_net_.forward();
-  if (output.empty()) {
-    return model_output;
-  }
-
-  const cv::Mat flattened = output.reshape(1, 1);
-  const int count = std::min<int>(static_cast<int>(kEmotionClassCount), flattened.cols);
-  for (int i = 0; i < count; ++i) {
-    model_output[static_cast<std::size_t>(i)] = flattened.at<float>(0, i);
+  if (faces_bgr.empty()) {
+    return;
   }
 
-  return NormalizeEmotionOutput(model_output);
-}
+  // Fill the batch blob straight from the persistent scratch buffers instead
+  // of going through blobFromImages; create() is a no-op while the batch size
+  // is stable, so steady-state preprocessing allocates nothing.
+  const int batch_size = static_cast<int>(faces_bgr.size());
+  const int blob_sizes[] = {batch_size, 1, kEmotionInputSize, kEmotionInputSize};
+  blob->create(4, blob_sizes, CV_32F);
 
-bool InferenceWorker::LooksLikeProbabilities(const std::array<float, kEmotionClassCount> &values)
-{
-  float sum = 0.0f;
-  for (const float value : values) {
-    if (!std::isfinite(value)) {
-      return false;
+  for (int face = 0; face < batch_size; ++face) {
+    cv::Mat plane(kEmotionInputSize, kEmotionInputSize, CV_32F, blob->ptr<float>(face));
+    const cv::Mat &face_bgr = faces_bgr[static_cast<std::size_t>(face)];
+    if (face_bgr.empty()) {
+      plane.setTo(0.0f);
+      continue;
     }
-    if (value < -0.001f || value > 1.001f) {
-      return false;
+
+    if (face_bgr.channels() == 1) {
+      cv::resize(
+        face_bgr, scratch_resized_, cv::Size(kEmotionInputSize, kEmotionInputSize), 0.0, 0.0, cv::INTER_LINEAR);
+    } else {
+      cv::cvtColor(face_bgr, scratch_gray_, cv::COLOR_BGR2GRAY);
+      cv::resize(
+        scratch_gray_, scratch_resized_, cv::Size(kEmotionInputSize, kEmotionInputSize), 0.0, 0.0, cv::INTER_LINEAR);
     }
-    sum += value;
+    cv::equalizeHist(scratch_resized_, scratch_resized_);
+    scratch_resized_.convertTo(plane, CV_32F);
   }
-  return sum > 0.85f && sum < 1.15f;
 }
 
-std::array<float, kEmotionClassCount> InferenceWorker::NormalizeEmotionOutput(
-  const std::array<float, kEmotionClassCount> &model_output)
+std::vector<std::array<float, kEmotionClassCount>> InferenceWorker::ForwardEmotionBlob(
+  const cv::Mat &blob, const std::size_t count)
 {
-  std::array<float, kEmotionClassCount> probs {};
-
-  if (LooksLikeProbabilities(model_output)) {
-    float sum = 0.0f;
-    for (std::size_t i = 0; i < kEmotionClassCount; ++i) {
-      probs[i] = std::clamp(model_output[i], 0.0f, 1.0f);
-      sum += probs[i];
-    }
-
-    if (sum > std::numeric_limits<float>::epsilon()) {
-      for (float &value : probs) {
-        value /= sum;
-      }
-      return probs;
-    }
-  }
-
-  const float max_logit = *std::max_element(model_output.begin(), model_output.end());
-
-  float sum = 0.0f;
-  for (std::size_t i = 0; i < kEmotionClassCount; ++i) {
-    probs[i] = std::exp(model_output[i] - max_logit);
-    sum += probs[i];
+  std::vector<std::array<float, kEmotionClassCount>> batch_output(count);
+  if (count == 0 || blob.empty()) {
+    return batch_output;
   }
 
-  if (sum <= std::numeric_limits<float>::epsilon()) {
-    probs.fill(1.0f / static_cast<float>(kEmotionClassCount));
-    return probs;
+  // All crops of the frame share one forward pass; the per-call dispatch
+  // overhead of the emotion net is paid once instead of once per face.
+  emotion_net_.setInput(blob);
+  const cv::Mat output = emotion_net_.forward();
+  if (output.empty()) {
+    return batch_output;
   }
 
-  for (float &value : probs) {
-    value /= sum;
+  // One output row per batched crop.
+  const cv::Mat rows = output.reshape(1, static_cast<int>(count));
+  const int cols = std::min<int>(static_cast<int>(kEmotionClassCount), rows.cols);
+  for (std::size_t face = 0; face < count; ++face) {
+    std::array<float, kEmotionClassCount> model_output {};
+    for (int i = 0; i < cols; ++i) {
+      model_output[static_cast<std::size_t>(i)] = rows.at<float>(static_cast<int>(face), i);
+    }
+    batch_output[face] = NormalizeEmotionOutput(model_output);
   }
 
-  return probs;
+  return batch_output;
 }
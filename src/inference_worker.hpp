@@ -2,10 +2,12 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstddef>
 #include <cstdint>
-#include <deque>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -15,36 +17,99 @@
 #include <opencv2/dnn.hpp>
 #include <opencv2/objdetect/face.hpp>
 
+#include "latency_stats.hpp"
 #include "tracker.hpp"
 
 class InferenceWorker {
 public:
+  // DNN execution backend for both networks. kAuto probes the available
+  // targets at Start and picks the fastest one; any accelerated target falls
+  // back to the CPU if inference throws at runtime.
+  enum class DnnBackend {
+    kAuto,
+    kCpu,
+    kOpenCl,
+    kOpenClFp16,
+    kCuda,
+  };
+
   struct Config {
     int max_faces = 3;
     int inference_width = 640;
     float confidence_threshold = 0.30f;
     float smoothing_seconds = 0.6f;
+    DnnBackend backend = DnnBackend::kAuto;
+    // Directory for on-disk kernel caches; empty disables persistence.
+    std::string cache_dir;
+    // When set, the worker steps the effective inference width between 320
+    // and inference_width to keep inference_ms near target_latency_ms.
+    bool adaptive_width = false;
+    float target_latency_ms = 33.0f;
+    // Thread scheduling, bound at Start like backend and cache_dir (a shared
+    // worker keeps the settings of whichever filter started it): below-normal
+    // priority, an optional CPU affinity bitmask (0 leaves placement to the
+    // OS) and a cap for OpenCV's internal pool (0 keeps OpenCV's default;
+    // note the pool is process-global, so the cap applies beyond the worker).
+    bool low_priority = false;
+    uint64_t affinity_mask = 0;
+    int opencv_threads = 0;
+    // Letterbox every frame into a constant inference_width-sided square for
+    // the detector, so setInputSize is called once at load and YuNet's
+    // prior/anchor state survives aspect-ratio and resolution changes. Bound
+    // at Start like the backend.
+    bool fixed_detector_input = false;
+    // Two-tier detection schedule: most cycles scan only expanded
+    // neighborhoods of the current tracks, with a full-frame sweep every
+    // full_sweep_interval_s seconds to pick up new entrants. ROI passes
+    // resize the detector per crop, so they bypass fixed_detector_input.
+    bool roi_detection = false;
+    float full_sweep_interval_s = 1.0f;
   };
 
+  // One worker is shared by every filter with the same model/backend key (see
+  // InferenceService); each filter registers as a client and gets its own
+  // tracker state, submission slot and result buffer.
+  using ClientId = uint64_t;
+
   InferenceWorker();
   ~InferenceWorker();
 
+  // backend and cache_dir from config are bound here; the per-client fields
+  // are ignored and come from RegisterClient/UpdateClientConfig instead.
   bool Start(const std::string &face_model_path, const std::string &emotion_model_path, const Config &config, std::string *error);
   void Stop();
 
-  void UpdateConfig(const Config &config);
-  void SubmitFrame(const cv::Mat &bgr_frame, uint64_t timestamp_ns, int source_width, int source_height);
+  ClientId RegisterClient(const Config &config);
+  void UnregisterClient(ClientId client_id);
+  void UpdateClientConfig(ClientId client_id, const Config &config);
 
-  bool TryConsumeLatest(std::vector<DetectedFace> *faces, double *inference_ms, uint64_t *timestamp_ns);
+  // image is either a CV_8UC3 BGR frame or a CV_8UC1 luma frame (the planar
+  // YUV fast path); the worker replicates gray input for the detector itself.
+  void SubmitFrame(ClientId client_id, const cv::Mat &image, uint64_t timestamp_ns, int source_width, int source_height);
+
+  bool TryConsumeLatest(ClientId client_id, std::vector<DetectedFace> *faces, double *inference_ms, uint64_t *timestamp_ns);
+  // Current width the adaptive controller settled on for this client (the
+  // configured width when the controller is off); the filter extracts at this
+  // width so downscale and inference stay in agreement.
+  int EffectiveInferenceWidth(ClientId client_id) const;
+  // Worker-side stage histograms (queue wait, detect, emotion, tracker);
+  // cumulative, so readers window them through Snapshot deltas.
+  const StageLatencyStats &Stats() const;
   std::size_t QueueSize() const;
   bool IsRunning() const;
+  // True once the detect thread has finished parsing both models; frames
+  // submitted before that are dropped.
+  bool IsReady() const;
 
 private:
   struct FrameTask {
-    cv::Mat bgr_frame;
+    // BGR or single-channel luma, at (or near) inference resolution.
+    cv::Mat image;
     uint64_t timestamp_ns = 0;
     int source_width = 0;
     int source_height = 0;
+    // Set by SubmitFrame so the worker can measure queue wait at pickup.
+    std::chrono::steady_clock::time_point enqueued_at {};
   };
 
   struct ResultPacket {
@@ -54,28 +119,149 @@ private:
     bool valid = false;
   };
 
-  void WorkerLoop();
-  std::vector<DetectedFace> RunInference(const FrameTask &task);
-  std::array<float, kEmotionClassCount> InferEmotion(const cv::Mat &face_bgr);
-  static std::array<float, kEmotionClassCount> NormalizeEmotionOutput(
-    const std::array<float, kEmotionClassCount> &model_output);
-  static bool LooksLikeProbabilities(const std::array<float, kEmotionClassCount> &values);
+  // Per-client state. The pending slot is guarded by state_mutex_; the result
+  // buffer is the same wait-free single-producer/single-consumer triple
+  // buffer the worker always used, now one per client: the emotion stage owns
+  // write_index, the client's video thread owns read_index, and the most
+  // recently published slot travels through shared_index together with a
+  // freshness bit.
+  struct ClientState {
+    // Immutable snapshot replaced wholesale by UpdateClientConfig; the detect
+    // thread grabs the pointer while it already holds state_mutex_ for the
+    // pending slot, so per-frame config access copies nothing.
+    std::shared_ptr<const Config> config;
+    FaceTracker tracker;
+
+    FrameTask pending;
+    bool has_pending = false;
 
-  mutable std::mutex config_mutex_;
-  Config config_;
+    static constexpr uint32_t kSlotMask = 0x3;
+    static constexpr uint32_t kFreshBit = 0x4;
+    std::array<ResultPacket, 3> result_slots;
+    uint32_t write_index = 0;
+    uint32_t read_index = 1;
+    std::atomic<uint32_t> shared_index {2};
 
-  mutable std::mutex queue_mutex_;
+    // Adaptive-width controller state; the width is read by the client's
+    // video thread, the rest belongs to the worker thread.
+    std::atomic<int> effective_width {0};
+    double latency_ema_ms = 0.0;
+    int results_since_adjust = 0;
+
+    // ROI re-detection schedule state: where the last result's tracks were,
+    // in source coordinates (written by the emotion stage after tracking,
+    // read by the detect stage, so guarded by state_mutex_), and when the
+    // frame was last swept in full (detect stage only).
+    std::vector<cv::Rect> last_track_boxes;
+    uint64_t last_full_sweep_ns = 0;
+  };
+
+  // One frame's detect-stage output in flight to the emotion stage. The blob
+  // already holds the preprocessed crops, so the emotion stage shares no
+  // scratch buffers with the detect thread; consumed blobs travel back
+  // through blob_pool_ and steady-state handoff allocates nothing.
+  struct DetectBatch {
+    std::shared_ptr<ClientState> client;
+    std::shared_ptr<const Config> config;
+    std::vector<RawFaceDetection> detections;
+    cv::Mat emotion_blob;
+    uint64_t timestamp_ns = 0;
+    // Detect-stage cost and the crop-preprocessing share of it, so the
+    // emotion stage can report a per-frame inference_ms that excludes
+    // pipeline wait and attribute the blob fill to the emotion histogram.
+    double detect_stage_ms = 0.0;
+    double blob_fill_ms = 0.0;
+    bool reset_tracker = false;
+    bool valid = false;
+  };
+
+  void DetectLoop();
+  void EmotionLoop();
+  void ApplySchedulingControls(bool log_summary);
+  // Scales frame into the top-left of the fixed square canvas (padding stays
+  // black); scale receives the per-axis canvas-from-frame factors so
+  // detections map back with a pure division.
+  cv::Mat LetterboxDetectorInput(const cv::Mat &frame, cv::Point2d *scale);
+  bool LoadNetworks();
+  void WarmUpNetworks();
+  cv::Mat AcquireFrameBuffer(int rows, int cols, int type);
+  void ReleaseFrameBuffer(cv::Mat &&buffer);
+  cv::Mat AcquireEmotionBlob();
+  void ReleaseEmotionBlob(cv::Mat &&blob);
+  static void PublishResult(ClientState *client, ResultPacket &&result);
+  std::shared_ptr<ClientState> NextPendingClientLocked(FrameTask *task);
+  static void UpdateAdaptiveWidth(ClientState *client, const Config &config, double inference_ms);
+  // Detect-stage half of a frame: preprocessing, detection (full sweep or ROI
+  // crops) and the crop-to-blob fill; track_boxes is the caller's copy of the
+  // client's last result boxes.
+  DetectBatch RunDetection(
+    ClientState *client, const Config &config, const FrameTask &task, const std::vector<cv::Rect> &track_boxes);
+  // Preprocesses the frame's crops into the NCHW batch blob on the detect
+  // thread; blob rows match crop order.
+  void FillEmotionBlob(const std::vector<cv::Mat> &faces_bgr, cv::Mat *blob);
+  // setInput + forward + per-row normalization; emotion thread only (the
+  // warmup call runs before the first batch can reach that thread).
+  std::vector<std::array<float, kEmotionClassCount>> ForwardEmotionBlob(const cv::Mat &blob, std::size_t count);
+  bool FallBackDetectorToCpu();
+
+  // Guards the client map, the per-client pending slots and configs, and the
+  // per-client last_track_boxes shared between the two stage threads.
+  mutable std::mutex state_mutex_;
   std::condition_variable queue_cv_;
-  std::deque<FrameTask> queue_;
+  std::map<ClientId, std::shared_ptr<ClientState>> clients_;
+  ClientId next_client_id_ = 1;
+  ClientId last_served_client_ = 0;
 
-  mutable std::mutex result_mutex_;
-  ResultPacket latest_result_;
+  mutable std::mutex pool_mutex_;
+  std::vector<cv::Mat> frame_pool_;
 
-  std::thread worker_thread_;
-  bool stop_requested_ = false;
+  std::thread detect_thread_;
+  std::thread emotion_thread_;
+  std::atomic<bool> stop_requested_ {false};
   std::atomic<bool> running_ {false};
+  std::atomic<bool> models_ready_ {false};
+
+  // Single-slot handoff between the stages: the detect thread blocks while
+  // the emotion stage still holds the previous frame, so at most two frames
+  // are in flight and frame N's emotion forward overlaps frame N+1's
+  // detection. blob_pool_ sends consumed batch blobs back to the detect
+  // thread for reuse.
+  std::mutex handoff_mutex_;
+  std::condition_variable handoff_cv_;
+  DetectBatch handoff_;
+  std::vector<cv::Mat> blob_pool_;
 
   cv::Ptr<cv::FaceDetectorYN> face_detector_;
   cv::dnn::Net emotion_net_;
-  FaceTracker tracker_;
+
+  // Resolved (never kAuto) backend in use; only touched on the detect thread.
+  // The model paths are kept for loading and the CPU fallback re-create.
+  DnnBackend active_backend_ = DnnBackend::kCpu;
+  DnnBackend requested_backend_ = DnnBackend::kAuto;
+  std::string face_model_path_;
+  std::string emotion_model_path_;
+  std::string cache_dir_;
+
+  // Scheduling controls bound at Start; applied on both stage threads.
+  bool low_priority_ = false;
+  uint64_t affinity_mask_ = 0;
+  int opencv_threads_ = 0;
+
+  // Fixed-letterbox detector input, bound at Start (detect thread only past
+  // that point).
+  bool fixed_detector_input_ = false;
+  int detector_input_size_ = 0;
+  cv::Mat scratch_letterbox_;
+  cv::Size letterbox_content_size_ {0, 0};
+
+  // Persistent preprocessing scratch, reused frame over frame so steady-state
+  // inference allocates nothing (detect thread only; the emotion thread works
+  // exclusively off the handed-over blob).
+  cv::Mat scratch_gray_;
+  cv::Mat scratch_resized_;
+  cv::Mat scratch_detector_input_;
+
+  // Only the worker-side stages are recorded here; the filter owns the
+  // video-thread histograms.
+  StageLatencyStats stage_stats_;
 };
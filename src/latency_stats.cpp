@@ -0,0 +1,49 @@
+#include "latency_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void LatencyHistogram::Record(const double ms)
+{
+  std::size_t bucket = kBucketCount;
+  if (ms <= 0.0) {
+    bucket = 0;
+  } else {
+    const std::size_t index = static_cast<std::size_t>(ms / kBucketWidthMs);
+    if (index < kBucketCount) {
+      bucket = index;
+    }
+  }
+  counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::Capture() const
+{
+  Snapshot snapshot;
+  for (std::size_t bucket = 0; bucket <= kBucketCount; ++bucket) {
+    snapshot.counts[bucket] = counts_[bucket].load(std::memory_order_relaxed);
+    snapshot.total += snapshot.counts[bucket];
+  }
+  return snapshot;
+}
+
+double LatencyHistogram::Percentile(const Snapshot &current, const Snapshot &previous, const double fraction)
+{
+  const uint64_t window_total = current.total - previous.total;
+  if (window_total == 0) {
+    return 0.0;
+  }
+
+  const uint64_t rank =
+    std::clamp<uint64_t>(static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(window_total))), 1, window_total);
+  uint64_t cumulative = 0;
+  for (std::size_t bucket = 0; bucket <= kBucketCount; ++bucket) {
+    cumulative += current.counts[bucket] - previous.counts[bucket];
+    if (cumulative >= rank) {
+      // The overflow bucket has no upper edge; report its floor.
+      const std::size_t edge_bucket = std::min(bucket + 1, kBucketCount);
+      return static_cast<double>(edge_bucket) * kBucketWidthMs;
+    }
+  }
+  return static_cast<double>(kBucketCount) * kBucketWidthMs;
+}
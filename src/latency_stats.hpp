@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-bucket latency histogram: 0.5 ms buckets up to 100 ms plus one
+// overflow bucket, so a 200 ms stall is counted instead of averaged away.
+// Record is a single relaxed fetch_add and safe from any thread; readers
+// work from Snapshot deltas, so every filter sharing a worker can window the
+// worker's histograms independently without resetting shared state.
+class LatencyHistogram {
+public:
+  static constexpr std::size_t kBucketCount = 200;
+  static constexpr double kBucketWidthMs = 0.5;
+
+  struct Snapshot {
+    std::array<uint64_t, kBucketCount + 1> counts {};
+    uint64_t total = 0;
+  };
+
+  void Record(double ms);
+  Snapshot Capture() const;
+
+  // Percentile over the samples recorded between two snapshots; fraction is
+  // in [0, 1]. Returns the upper edge of the bucket holding the requested
+  // rank, the overflow floor (100 ms) for samples past the last bucket, and
+  // 0 when the window holds no samples.
+  static double Percentile(const Snapshot &current, const Snapshot &previous, double fraction);
+
+private:
+  std::array<std::atomic<uint64_t>, kBucketCount + 1> counts_ {};
+};
+
+// One histogram per pipeline stage. Ownership follows the threads that run
+// the stages: InferenceWorker records queue_wait, detect, emotion and
+// tracker; the filter records extract, overlay and write_back on the video
+// thread and reads both sets for the periodic log.
+struct StageLatencyStats {
+  LatencyHistogram extract;     // source frame -> BGR/luma on the submit path
+  LatencyHistogram queue_wait;  // SubmitFrame to worker pickup
+  LatencyHistogram detect;      // face detector forward + box parsing
+  LatencyHistogram emotion;     // emotion batch preprocessing + forward
+  LatencyHistogram tracker;     // assignment, smoothing and coasting
+  LatencyHistogram overlay;     // CPU overlay draw (incl. full-res extract)
+  LatencyHistogram write_back;  // dirty-region conversion back into the frame
+};
+
+// Window baselines for percentile reporting, one snapshot per stage.
+struct StageLatencyBaselines {
+  LatencyHistogram::Snapshot extract;
+  LatencyHistogram::Snapshot queue_wait;
+  LatencyHistogram::Snapshot detect;
+  LatencyHistogram::Snapshot emotion;
+  LatencyHistogram::Snapshot tracker;
+  LatencyHistogram::Snapshot overlay;
+  LatencyHistogram::Snapshot write_back;
+};
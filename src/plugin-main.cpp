@@ -2,6 +2,8 @@
 #include <plugin-support.h>
 
 #include "face_emotion_filter.hpp"
+#include "inference_service.hpp"
+#include "yuv_convert.hpp"
 
 OBS_DECLARE_MODULE()
 OBS_MODULE_USE_DEFAULT_LOCALE(PLUGIN_NAME, "fr-FR")
@@ -13,12 +15,15 @@ MODULE_EXPORT const char *obs_module_description(void)
 
 bool obs_module_load(void)
 {
+  InferenceService::Load();
   obs_register_source(GetFaceEmotionFilterSourceInfo());
-  obs_log(LOG_INFO, "plugin loaded successfully (version %s)", PLUGIN_VERSION);
+  obs_log(LOG_INFO, "plugin loaded successfully (version %s, yuv kernels: %s)", PLUGIN_VERSION,
+          yuv_convert::ActiveKernelSet());
   return true;
 }
 
 void obs_module_unload(void)
 {
+  InferenceService::Unload();
   obs_log(LOG_INFO, "plugin unloaded");
 }
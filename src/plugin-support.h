@@ -18,6 +18,16 @@ extern "C" {
 extern const char *PLUGIN_NAME;
 extern const char *PLUGIN_VERSION;
 
+/* Log-level constants matching libobs' util/base.h, so translation units that
+ * only log (and the standalone tools, which build without libobs headers)
+ * need nothing beyond this header. */
+#ifndef LOG_ERROR
+#define LOG_ERROR 100
+#define LOG_WARNING 200
+#define LOG_INFO 300
+#define LOG_DEBUG 400
+#endif
+
 void obs_log(int log_level, const char *format, ...);
 extern void blogva(int log_level, const char *format, va_list args);
 
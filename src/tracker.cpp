@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <utility>
 
 namespace {
@@ -59,6 +60,92 @@ ComputeStableLabel(const std::array<float, kEmotionClassCount> &probs, const flo
   return {label, Clamp01(best_value)};
 }
 
+// Cost assigned to track/detection pairs ruled out by the spatial pre-filter;
+// any real pair costs at most 1, so forbidden pairs never win an assignment.
+constexpr float kForbiddenCost = 1.0e6f;
+constexpr float kIouThreshold = 0.2f;
+
+// Minimum-cost assignment via the Hungarian algorithm with potentials
+// (Jonker-Volgenant row augmentation, O(rows^2 * cols)). cost is row-major
+// rows x cols with rows <= cols; returns the matched column per row.
+std::vector<int> SolveAssignment(const std::vector<float> &cost, const int rows, const int cols)
+{
+  constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+  // 1-indexed potentials and matching, column 0 is the virtual start node.
+  std::vector<double> row_potential(static_cast<std::size_t>(rows) + 1, 0.0);
+  std::vector<double> col_potential(static_cast<std::size_t>(cols) + 1, 0.0);
+  std::vector<int> matched_row(static_cast<std::size_t>(cols) + 1, 0);
+  std::vector<int> augment_path(static_cast<std::size_t>(cols) + 1, 0);
+
+  for (int row = 1; row <= rows; ++row) {
+    matched_row[0] = row;
+    int current_col = 0;
+    std::vector<double> min_slack(static_cast<std::size_t>(cols) + 1, kInfinity);
+    std::vector<bool> visited(static_cast<std::size_t>(cols) + 1, false);
+
+    do {
+      visited[static_cast<std::size_t>(current_col)] = true;
+      const int current_row = matched_row[static_cast<std::size_t>(current_col)];
+      double delta = kInfinity;
+      int next_col = 0;
+
+      for (int col = 1; col <= cols; ++col) {
+        if (visited[static_cast<std::size_t>(col)]) {
+          continue;
+        }
+
+        const double reduced =
+          static_cast<double>(cost[static_cast<std::size_t>(current_row - 1) * cols + (col - 1)]) -
+          row_potential[static_cast<std::size_t>(current_row)] - col_potential[static_cast<std::size_t>(col)];
+        if (reduced < min_slack[static_cast<std::size_t>(col)]) {
+          min_slack[static_cast<std::size_t>(col)] = reduced;
+          augment_path[static_cast<std::size_t>(col)] = current_col;
+        }
+        if (min_slack[static_cast<std::size_t>(col)] < delta) {
+          delta = min_slack[static_cast<std::size_t>(col)];
+          next_col = col;
+        }
+      }
+
+      for (int col = 0; col <= cols; ++col) {
+        if (visited[static_cast<std::size_t>(col)]) {
+          row_potential[static_cast<std::size_t>(matched_row[static_cast<std::size_t>(col)])] += delta;
+          col_potential[static_cast<std::size_t>(col)] -= delta;
+        } else {
+          min_slack[static_cast<std::size_t>(col)] -= delta;
+        }
+      }
+      current_col = next_col;
+    } while (matched_row[static_cast<std::size_t>(current_col)] != 0);
+
+    while (current_col != 0) {
+      const int previous_col = augment_path[static_cast<std::size_t>(current_col)];
+      matched_row[static_cast<std::size_t>(current_col)] = matched_row[static_cast<std::size_t>(previous_col)];
+      current_col = previous_col;
+    }
+  }
+
+  std::vector<int> row_to_col(static_cast<std::size_t>(rows), -1);
+  for (int col = 1; col <= cols; ++col) {
+    if (matched_row[static_cast<std::size_t>(col)] != 0) {
+      row_to_col[static_cast<std::size_t>(matched_row[static_cast<std::size_t>(col)] - 1)] = col - 1;
+    }
+  }
+  return row_to_col;
+}
+
+// Tracks unseen for longer than this are dropped; below it they coast on
+// their last velocity so the overlay survives missed detections at low
+// inference rates.
+constexpr double kCoastTtlSeconds = 1.0;
+// Blend weight for the per-result velocity estimate; 0.5 follows direction
+// changes within two results without letting one noisy box swing the track.
+constexpr float kVelocityEmaAlpha = 0.5f;
+// Velocity decay applied on every coasted update so an unseen track slows
+// down instead of drifting indefinitely.
+constexpr float kCoastVelocityDecay = 0.8f;
+
 } // namespace
 
 std::vector<DetectedFace> FaceTracker::Update(
@@ -70,11 +157,6 @@ std::vector<DetectedFace> FaceTracker::Update(
 {
   std::vector<DetectedFace> output_faces;
 
-  if (detections.empty()) {
-    tracks_.clear();
-    return output_faces;
-  }
-
   std::vector<RawFaceDetection> limited = detections;
   std::sort(
     limited.begin(),
@@ -91,53 +173,91 @@ std::vector<DetectedFace> FaceTracker::Update(
 
   std::vector<int> track_to_detection(track_count, -1);
   std::vector<bool> detection_used(detection_count, false);
-  std::vector<bool> track_used(track_count, false);
-
-  constexpr float kIouThreshold = 0.2f;
-  while (true) {
-    float best_iou = kIouThreshold;
-    int best_track = -1;
-    int best_detection = -1;
 
+  if (track_count > 0 && detection_count > 0) {
+    // Globally optimal matching on a 1-IoU cost matrix instead of the old
+    // repeated greedy scan, which went cubic in face count. The spatial
+    // pre-filter leaves disjoint pairs at the forbidden cost without scoring
+    // them: the intersection test is a handful of comparisons versus the
+    // areas and division a full IoU needs.
+    const bool tracks_as_rows = track_count <= detection_count;
+    const std::size_t rows = tracks_as_rows ? track_count : detection_count;
+    const std::size_t cols = tracks_as_rows ? detection_count : track_count;
+
+    std::vector<float> cost(rows * cols, kForbiddenCost);
+    bool any_candidate = false;
     for (std::size_t track_index = 0; track_index < track_count; ++track_index) {
-      if (track_used[track_index]) {
-        continue;
-      }
-
       for (std::size_t detection_index = 0; detection_index < detection_count; ++detection_index) {
-        if (detection_used[detection_index]) {
+        const cv::Rect &track_bbox = tracks_[track_index].bbox;
+        const cv::Rect &detection_bbox = limited[detection_index].bbox;
+        if ((track_bbox & detection_bbox).empty()) {
           continue;
         }
 
-        const float iou = ComputeIoU(tracks_[track_index].bbox, limited[detection_index].bbox);
-        if (iou > best_iou) {
-          best_iou = iou;
-          best_track = static_cast<int>(track_index);
-          best_detection = static_cast<int>(detection_index);
+        const float iou = ComputeIoU(track_bbox, detection_bbox);
+        if (iou <= kIouThreshold) {
+          continue;
         }
+
+        const std::size_t row = tracks_as_rows ? track_index : detection_index;
+        const std::size_t col = tracks_as_rows ? detection_index : track_index;
+        cost[row * cols + col] = 1.0f - iou;
+        any_candidate = true;
       }
     }
 
-    if (best_track < 0 || best_detection < 0) {
-      break;
-    }
+    if (any_candidate) {
+      const std::vector<int> row_to_col =
+        SolveAssignment(cost, static_cast<int>(rows), static_cast<int>(cols));
+      for (std::size_t row = 0; row < rows; ++row) {
+        const int col = row_to_col[row];
+        if (col < 0 || cost[row * cols + static_cast<std::size_t>(col)] >= kForbiddenCost) {
+          continue;
+        }
 
-    track_used[static_cast<std::size_t>(best_track)] = true;
-    detection_used[static_cast<std::size_t>(best_detection)] = true;
-    track_to_detection[static_cast<std::size_t>(best_track)] = best_detection;
+        const std::size_t track_index = tracks_as_rows ? row : static_cast<std::size_t>(col);
+        const std::size_t detection_index = tracks_as_rows ? static_cast<std::size_t>(col) : row;
+        track_to_detection[track_index] = static_cast<int>(detection_index);
+        detection_used[detection_index] = true;
+      }
+    }
   }
 
   std::vector<TrackState> next_tracks;
-  next_tracks.reserve(limited.size());
-  output_faces.reserve(limited.size());
+  next_tracks.reserve(limited.size() + track_count);
+  output_faces.reserve(limited.size() + track_count);
 
   for (std::size_t track_index = 0; track_index < track_count; ++track_index) {
     const int detection_index = track_to_detection[track_index];
+    TrackState track = tracks_[track_index];
+
     if (detection_index < 0) {
+      // Unmatched: coast on the last velocity until the TTL runs out, so a
+      // missed detection (or an empty result) does not blank the overlay.
+      const double unseen_seconds =
+        (track.last_seen_ns > 0 && timestamp_ns >= track.last_seen_ns)
+          ? static_cast<double>(timestamp_ns - track.last_seen_ns) / 1'000'000'000.0
+          : kCoastTtlSeconds;
+      if (unseen_seconds >= kCoastTtlSeconds) {
+        continue;
+      }
+
+      const double coast_dt_seconds =
+        (track.last_update_ns > 0 && timestamp_ns >= track.last_update_ns)
+          ? static_cast<double>(timestamp_ns - track.last_update_ns) / 1'000'000'000.0
+          : 0.0;
+      track.bbox.x += static_cast<int>(std::lround(track.velocity.x * coast_dt_seconds));
+      track.bbox.y += static_cast<int>(std::lround(track.velocity.y * coast_dt_seconds));
+      track.velocity *= kCoastVelocityDecay;
+      track.last_update_ns = timestamp_ns;
+
+      next_tracks.push_back(track);
+      output_faces.push_back(
+        DetectedFace {track.track_id, track.bbox, {}, track.stable_label, track.stable_conf, timestamp_ns,
+                      track.velocity});
       continue;
     }
 
-    TrackState track = tracks_[track_index];
     const auto &detection = limited[static_cast<std::size_t>(detection_index)];
 
     const double dt_seconds =
@@ -150,8 +270,24 @@ std::vector<DetectedFace> FaceTracker::Update(
       track.ema_probs[i] = alpha * detection.probs_raw[i] + (1.0f - alpha) * track.ema_probs[i];
     }
 
+    // Constant-velocity estimate from consecutive matched boxes, smoothed so
+    // one noisy detection cannot fling the coasting prediction.
+    if (track.last_seen_ns > 0 && timestamp_ns > track.last_seen_ns && dt_seconds < kCoastTtlSeconds) {
+      const cv::Point2f previous_center(
+        static_cast<float>(track.bbox.x) + static_cast<float>(track.bbox.width) * 0.5f,
+        static_cast<float>(track.bbox.y) + static_cast<float>(track.bbox.height) * 0.5f);
+      const cv::Point2f current_center(
+        static_cast<float>(detection.bbox.x) + static_cast<float>(detection.bbox.width) * 0.5f,
+        static_cast<float>(detection.bbox.y) + static_cast<float>(detection.bbox.height) * 0.5f);
+      const cv::Point2f instantaneous = (current_center - previous_center) / static_cast<float>(dt_seconds);
+      track.velocity = kVelocityEmaAlpha * instantaneous + (1.0f - kVelocityEmaAlpha) * track.velocity;
+    } else {
+      track.velocity = cv::Point2f(0.0f, 0.0f);
+    }
+
     track.bbox = detection.bbox;
     track.last_seen_ns = timestamp_ns;
+    track.last_update_ns = timestamp_ns;
 
     const auto [stable_label, stable_conf] = ComputeStableLabel(track.ema_probs, confidence_threshold);
     track.stable_label = stable_label;
@@ -159,7 +295,8 @@ std::vector<DetectedFace> FaceTracker::Update(
 
     next_tracks.push_back(track);
     output_faces.push_back(
-      DetectedFace {track.track_id, detection.bbox, detection.probs_raw, stable_label, stable_conf, timestamp_ns});
+      DetectedFace {track.track_id, detection.bbox, detection.probs_raw, stable_label, stable_conf, timestamp_ns,
+                    track.velocity});
   }
 
   for (std::size_t detection_index = 0; detection_index < detection_count; ++detection_index) {
@@ -171,6 +308,7 @@ std::vector<DetectedFace> FaceTracker::Update(
     track.track_id = next_track_id_++;
     track.bbox = limited[detection_index].bbox;
     track.last_seen_ns = timestamp_ns;
+    track.last_update_ns = timestamp_ns;
     track.ema_probs = limited[detection_index].probs_raw;
 
     const auto [stable_label, stable_conf] = ComputeStableLabel(track.ema_probs, confidence_threshold);
@@ -188,6 +326,10 @@ std::vector<DetectedFace> FaceTracker::Update(
     output_faces.begin(),
     output_faces.end(),
     [](const DetectedFace &lhs, const DetectedFace &rhs) { return lhs.bbox.area() > rhs.bbox.area(); });
+  // Coasted tracks can push the output past the cap detections alone respect.
+  if (static_cast<int>(output_faces.size()) > clamped_max_faces) {
+    output_faces.resize(static_cast<std::size_t>(clamped_max_faces));
+  }
   return output_faces;
 }
 
@@ -15,6 +15,9 @@ struct DetectedFace {
   Emotion label = Emotion::Incertain;
   float confidence = 0.0f;
   uint64_t ts_ns = 0;
+  // Box-center velocity in source pixels per second, for extrapolating the
+  // overlay between inference results.
+  cv::Point2f velocity {0.0f, 0.0f};
 };
 
 struct TrackState {
@@ -23,7 +26,13 @@ struct TrackState {
   std::array<float, kEmotionClassCount> ema_probs {};
   Emotion stable_label = Emotion::Incertain;
   float stable_conf = 0.0f;
+  // Last time a detection matched this track; coasting keeps the track alive
+  // past a miss until the TTL expires.
   uint64_t last_seen_ns = 0;
+  // Last Update call that touched the track (matched or coasted), so coasting
+  // steps never compound.
+  uint64_t last_update_ns = 0;
+  cv::Point2f velocity {0.0f, 0.0f};
 };
 
 struct RawFaceDetection {
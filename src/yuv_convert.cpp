@@ -0,0 +1,654 @@
+#include "yuv_convert.hpp"
+#include "yuv_convert_detail.hpp"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define YUV_CONVERT_HAVE_NEON 1
+#endif
+
+namespace yuv_convert {
+
+// Entry points of the AVX2 translation unit (stubs on non-x86 builds).
+namespace detail {
+
+bool HaveAvx2Kernels();
+
+void I420ToBgrAvx2(
+  const uint8_t *y,
+  std::size_t y_stride,
+  const uint8_t *u,
+  std::size_t u_stride,
+  const uint8_t *v,
+  std::size_t v_stride,
+  uint8_t *bgr,
+  std::size_t bgr_stride,
+  int width,
+  int height);
+
+void BgrToI420Avx2(
+  const uint8_t *bgr,
+  std::size_t bgr_stride,
+  uint8_t *y,
+  std::size_t y_stride,
+  uint8_t *u,
+  std::size_t u_stride,
+  uint8_t *v,
+  std::size_t v_stride,
+  int width,
+  int height);
+
+void BgrToNv12Avx2(
+  const uint8_t *bgr,
+  std::size_t bgr_stride,
+  uint8_t *y,
+  std::size_t y_stride,
+  uint8_t *uv,
+  std::size_t uv_stride,
+  int width,
+  int height);
+
+void Narrow10To8Avx2(
+  const uint16_t *src,
+  std::size_t src_stride,
+  uint8_t *dst,
+  std::size_t dst_stride,
+  int samples_per_row,
+  int rows,
+  int shift);
+
+} // namespace detail
+
+namespace {
+
+using detail::BgrPixelToU;
+using detail::BgrPixelToV;
+using detail::BgrPixelToY;
+using detail::YuvToBgrPixel;
+
+// The scalar kernels double as the reference implementation and the fallback
+// for builds without a SIMD kernel set.
+[[maybe_unused]] void I420ToBgrScalar(
+  const uint8_t *y,
+  const std::size_t y_stride,
+  const uint8_t *u,
+  const std::size_t u_stride,
+  const uint8_t *v,
+  const std::size_t v_stride,
+  uint8_t *bgr,
+  const std::size_t bgr_stride,
+  const int width,
+  const int height)
+{
+  for (int row = 0; row < height; row += 2) {
+    const uint8_t *y0 = y + static_cast<std::size_t>(row) * y_stride;
+    const uint8_t *y1 = y0 + y_stride;
+    const uint8_t *u_row = u + static_cast<std::size_t>(row / 2) * u_stride;
+    const uint8_t *v_row = v + static_cast<std::size_t>(row / 2) * v_stride;
+    uint8_t *bgr0 = bgr + static_cast<std::size_t>(row) * bgr_stride;
+    uint8_t *bgr1 = bgr0 + bgr_stride;
+
+    for (int col = 0; col < width; col += 2) {
+      const int d_u = u_row[col / 2] - 128;
+      const int d_v = v_row[col / 2] - 128;
+      YuvToBgrPixel(y0[col], d_u, d_v, bgr0 + 3 * col);
+      YuvToBgrPixel(y0[col + 1], d_u, d_v, bgr0 + 3 * (col + 1));
+      YuvToBgrPixel(y1[col], d_u, d_v, bgr1 + 3 * col);
+      YuvToBgrPixel(y1[col + 1], d_u, d_v, bgr1 + 3 * (col + 1));
+    }
+  }
+}
+
+[[maybe_unused]] void BgrToI420Scalar(
+  const uint8_t *bgr,
+  const std::size_t bgr_stride,
+  uint8_t *y,
+  const std::size_t y_stride,
+  uint8_t *u,
+  const std::size_t u_stride,
+  uint8_t *v,
+  const std::size_t v_stride,
+  const int width,
+  const int height)
+{
+  for (int row = 0; row < height; row += 2) {
+    const uint8_t *bgr0 = bgr + static_cast<std::size_t>(row) * bgr_stride;
+    const uint8_t *bgr1 = bgr0 + bgr_stride;
+    uint8_t *y0 = y + static_cast<std::size_t>(row) * y_stride;
+    uint8_t *y1 = y0 + y_stride;
+    uint8_t *u_row = u + static_cast<std::size_t>(row / 2) * u_stride;
+    uint8_t *v_row = v + static_cast<std::size_t>(row / 2) * v_stride;
+
+    for (int col = 0; col < width; col += 2) {
+      const uint8_t *p00 = bgr0 + 3 * col;
+      const uint8_t *p01 = p00 + 3;
+      const uint8_t *p10 = bgr1 + 3 * col;
+      const uint8_t *p11 = p10 + 3;
+
+      y0[col] = BgrPixelToY(p00[0], p00[1], p00[2]);
+      y0[col + 1] = BgrPixelToY(p01[0], p01[1], p01[2]);
+      y1[col] = BgrPixelToY(p10[0], p10[1], p10[2]);
+      y1[col + 1] = BgrPixelToY(p11[0], p11[1], p11[2]);
+
+      // Chroma is sampled from the top-left pixel of each 2x2 block, matching
+      // OpenCV's BGR2YUV_I420 behavior.
+      u_row[col / 2] = BgrPixelToU(p00[0], p00[1], p00[2]);
+      v_row[col / 2] = BgrPixelToV(p00[0], p00[1], p00[2]);
+    }
+  }
+}
+
+[[maybe_unused]] void BgrToNv12Scalar(
+  const uint8_t *bgr,
+  const std::size_t bgr_stride,
+  uint8_t *y,
+  const std::size_t y_stride,
+  uint8_t *uv,
+  const std::size_t uv_stride,
+  const int width,
+  const int height)
+{
+  for (int row = 0; row < height; row += 2) {
+    const uint8_t *bgr0 = bgr + static_cast<std::size_t>(row) * bgr_stride;
+    const uint8_t *bgr1 = bgr0 + bgr_stride;
+    uint8_t *y0 = y + static_cast<std::size_t>(row) * y_stride;
+    uint8_t *y1 = y0 + y_stride;
+    uint8_t *uv_row = uv + static_cast<std::size_t>(row / 2) * uv_stride;
+
+    for (int col = 0; col < width; col += 2) {
+      const uint8_t *p00 = bgr0 + 3 * col;
+      const uint8_t *p01 = p00 + 3;
+      const uint8_t *p10 = bgr1 + 3 * col;
+      const uint8_t *p11 = p10 + 3;
+
+      y0[col] = BgrPixelToY(p00[0], p00[1], p00[2]);
+      y0[col + 1] = BgrPixelToY(p01[0], p01[1], p01[2]);
+      y1[col] = BgrPixelToY(p10[0], p10[1], p10[2]);
+      y1[col + 1] = BgrPixelToY(p11[0], p11[1], p11[2]);
+
+      uv_row[col] = BgrPixelToU(p00[0], p00[1], p00[2]);
+      uv_row[col + 1] = BgrPixelToV(p00[0], p00[1], p00[2]);
+    }
+  }
+}
+
+[[maybe_unused]] void Narrow10To8Scalar(
+  const uint16_t *src,
+  const std::size_t src_stride,
+  uint8_t *dst,
+  const std::size_t dst_stride,
+  const int samples_per_row,
+  const int rows,
+  const int shift)
+{
+  for (int row = 0; row < rows; ++row) {
+    const uint16_t *src_row =
+      reinterpret_cast<const uint16_t *>(reinterpret_cast<const uint8_t *>(src) + static_cast<std::size_t>(row) * src_stride);
+    uint8_t *dst_row = dst + static_cast<std::size_t>(row) * dst_stride;
+    for (int col = 0; col < samples_per_row; ++col) {
+      dst_row[col] = static_cast<uint8_t>(src_row[col] >> shift);
+    }
+  }
+}
+
+#if defined(YUV_CONVERT_HAVE_NEON)
+
+void Narrow10To8Neon(
+  const uint16_t *src,
+  const std::size_t src_stride,
+  uint8_t *dst,
+  const std::size_t dst_stride,
+  const int samples_per_row,
+  const int rows,
+  const int shift)
+{
+  const int simd_width = samples_per_row & ~15;
+  const int16x8_t shift_vec = vdupq_n_s16(static_cast<int16_t>(-shift));
+
+  for (int row = 0; row < rows; ++row) {
+    const uint16_t *src_row =
+      reinterpret_cast<const uint16_t *>(reinterpret_cast<const uint8_t *>(src) + static_cast<std::size_t>(row) * src_stride);
+    uint8_t *dst_row = dst + static_cast<std::size_t>(row) * dst_stride;
+
+    for (int col = 0; col < simd_width; col += 16) {
+      const uint16x8_t lo = vshlq_u16(vld1q_u16(src_row + col), shift_vec);
+      const uint16x8_t hi = vshlq_u16(vld1q_u16(src_row + col + 8), shift_vec);
+      vst1q_u8(dst_row + col, vcombine_u8(vqmovn_u16(lo), vqmovn_u16(hi)));
+    }
+
+    for (int col = simd_width; col < samples_per_row; ++col) {
+      dst_row[col] = static_cast<uint8_t>(src_row[col] >> shift);
+    }
+  }
+}
+
+// Converts 4 widened 32-bit lanes per call; callers pass max(0, y - 16) * kCY.
+inline int32x4_t NeonMulAddShift(const int32x4_t luma, const int32x4_t chroma_sum)
+{
+  return vshrq_n_s32(vaddq_s32(vaddq_s32(luma, chroma_sum), vdupq_n_s32(detail::kHalf)), detail::kShift);
+}
+
+inline uint8x8_t NeonPackU8(const int32x4_t lo, const int32x4_t hi)
+{
+  return vqmovn_u16(vcombine_u16(vqmovun_s32(lo), vqmovun_s32(hi)));
+}
+
+// One luma row of 16 pixels against duplicated chroma differences.
+inline uint8x16x3_t NeonYuvRowToBgr(
+  const uint8x16_t y_vec,
+  const int32x4_t d_u[4],
+  const int32x4_t d_v[4])
+{
+  const uint16x8_t y_lo = vmovl_u8(vget_low_u8(y_vec));
+  const uint16x8_t y_hi = vmovl_u8(vget_high_u8(y_vec));
+  const uint16x8_t y16 = vdupq_n_u16(16);
+
+  int32x4_t luma[4];
+  luma[0] = vmulq_n_s32(vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vqsubq_u16(y_lo, y16)))), detail::kCY);
+  luma[1] = vmulq_n_s32(vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(vqsubq_u16(y_lo, y16)))), detail::kCY);
+  luma[2] = vmulq_n_s32(vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vqsubq_u16(y_hi, y16)))), detail::kCY);
+  luma[3] = vmulq_n_s32(vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(vqsubq_u16(y_hi, y16)))), detail::kCY);
+
+  int32x4_t b[4];
+  int32x4_t g[4];
+  int32x4_t r[4];
+  for (int i = 0; i < 4; ++i) {
+    b[i] = NeonMulAddShift(luma[i], vmulq_n_s32(d_u[i], detail::kCUB));
+    g[i] = NeonMulAddShift(luma[i], vaddq_s32(vmulq_n_s32(d_u[i], detail::kCUG), vmulq_n_s32(d_v[i], detail::kCVG)));
+    r[i] = NeonMulAddShift(luma[i], vmulq_n_s32(d_v[i], detail::kCVR));
+  }
+
+  uint8x16x3_t bgr;
+  bgr.val[0] = vcombine_u8(NeonPackU8(b[0], b[1]), NeonPackU8(b[2], b[3]));
+  bgr.val[1] = vcombine_u8(NeonPackU8(g[0], g[1]), NeonPackU8(g[2], g[3]));
+  bgr.val[2] = vcombine_u8(NeonPackU8(r[0], r[1]), NeonPackU8(r[2], r[3]));
+  return bgr;
+}
+
+void I420ToBgrNeon(
+  const uint8_t *y,
+  const std::size_t y_stride,
+  const uint8_t *u,
+  const std::size_t u_stride,
+  const uint8_t *v,
+  const std::size_t v_stride,
+  uint8_t *bgr,
+  const std::size_t bgr_stride,
+  const int width,
+  const int height)
+{
+  const int simd_width = width & ~15;
+
+  for (int row = 0; row < height; row += 2) {
+    const uint8_t *y0 = y + static_cast<std::size_t>(row) * y_stride;
+    const uint8_t *y1 = y0 + y_stride;
+    const uint8_t *u_row = u + static_cast<std::size_t>(row / 2) * u_stride;
+    const uint8_t *v_row = v + static_cast<std::size_t>(row / 2) * v_stride;
+    uint8_t *bgr0 = bgr + static_cast<std::size_t>(row) * bgr_stride;
+    uint8_t *bgr1 = bgr0 + bgr_stride;
+
+    for (int col = 0; col < simd_width; col += 16) {
+      const int16x8_t bias = vdupq_n_s16(128);
+      const int16x8_t u16 =
+        vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(u_row + col / 2))), bias);
+      const int16x8_t v16 =
+        vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(v_row + col / 2))), bias);
+
+      // Duplicate each chroma sample across its 2-pixel span, then widen.
+      const int16x8x2_t u_dup = vzipq_s16(u16, u16);
+      const int16x8x2_t v_dup = vzipq_s16(v16, v16);
+
+      int32x4_t d_u[4];
+      int32x4_t d_v[4];
+      d_u[0] = vmovl_s16(vget_low_s16(u_dup.val[0]));
+      d_u[1] = vmovl_s16(vget_high_s16(u_dup.val[0]));
+      d_u[2] = vmovl_s16(vget_low_s16(u_dup.val[1]));
+      d_u[3] = vmovl_s16(vget_high_s16(u_dup.val[1]));
+      d_v[0] = vmovl_s16(vget_low_s16(v_dup.val[0]));
+      d_v[1] = vmovl_s16(vget_high_s16(v_dup.val[0]));
+      d_v[2] = vmovl_s16(vget_low_s16(v_dup.val[1]));
+      d_v[3] = vmovl_s16(vget_high_s16(v_dup.val[1]));
+
+      const uint8x16x3_t bgr_top = NeonYuvRowToBgr(vld1q_u8(y0 + col), d_u, d_v);
+      const uint8x16x3_t bgr_bottom = NeonYuvRowToBgr(vld1q_u8(y1 + col), d_u, d_v);
+      vst3q_u8(bgr0 + 3 * col, bgr_top);
+      vst3q_u8(bgr1 + 3 * col, bgr_bottom);
+    }
+
+    for (int col = simd_width; col < width; col += 2) {
+      const int d_u = u_row[col / 2] - 128;
+      const int d_v = v_row[col / 2] - 128;
+      YuvToBgrPixel(y0[col], d_u, d_v, bgr0 + 3 * col);
+      YuvToBgrPixel(y0[col + 1], d_u, d_v, bgr0 + 3 * (col + 1));
+      YuvToBgrPixel(y1[col], d_u, d_v, bgr1 + 3 * col);
+      YuvToBgrPixel(y1[col + 1], d_u, d_v, bgr1 + 3 * (col + 1));
+    }
+  }
+}
+
+// Weighted sum of 4 widened lanes, shifted back to bytes by the caller.
+inline int32x4_t NeonWeigh(
+  const int32x4_t b,
+  const int32x4_t g,
+  const int32x4_t r,
+  const int cb,
+  const int cg,
+  const int cr,
+  const int bias)
+{
+  int32x4_t sum = vmulq_n_s32(r, cr);
+  sum = vaddq_s32(sum, vmulq_n_s32(g, cg));
+  sum = vaddq_s32(sum, vmulq_n_s32(b, cb));
+  sum = vaddq_s32(sum, vdupq_n_s32(detail::kHalf + bias));
+  return vshrq_n_s32(sum, detail::kShift);
+}
+
+inline void NeonWiden16(const uint8x16_t bytes, int32x4_t out[4])
+{
+  const uint16x8_t lo = vmovl_u8(vget_low_u8(bytes));
+  const uint16x8_t hi = vmovl_u8(vget_high_u8(bytes));
+  out[0] = vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(lo)));
+  out[1] = vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(lo)));
+  out[2] = vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(hi)));
+  out[3] = vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(hi)));
+}
+
+inline uint8x16_t NeonBgrRowToY(const uint8x16x3_t bgr)
+{
+  int32x4_t b[4];
+  int32x4_t g[4];
+  int32x4_t r[4];
+  NeonWiden16(bgr.val[0], b);
+  NeonWiden16(bgr.val[1], g);
+  NeonWiden16(bgr.val[2], r);
+
+  int32x4_t y[4];
+  for (int i = 0; i < 4; ++i) {
+    y[i] = NeonWeigh(b[i], g[i], r[i], detail::kCBY, detail::kCGY, detail::kCRY, detail::kShifted16);
+  }
+  return vcombine_u8(NeonPackU8(y[0], y[1]), NeonPackU8(y[2], y[3]));
+}
+
+// Chroma for 16 pixels of the top row: 8 U and 8 V bytes from even columns.
+inline void NeonBgrRowToUv(const uint8x16x3_t bgr, uint8x8_t *u_out, uint8x8_t *v_out)
+{
+  const uint8x16_t b_even = vuzpq_u8(bgr.val[0], bgr.val[0]).val[0];
+  const uint8x16_t g_even = vuzpq_u8(bgr.val[1], bgr.val[1]).val[0];
+  const uint8x16_t r_even = vuzpq_u8(bgr.val[2], bgr.val[2]).val[0];
+
+  int32x4_t b[4];
+  int32x4_t g[4];
+  int32x4_t r[4];
+  NeonWiden16(b_even, b);
+  NeonWiden16(g_even, g);
+  NeonWiden16(r_even, r);
+
+  const int32x4_t u_lo = NeonWeigh(b[0], g[0], r[0], detail::kCBU, detail::kCGU, detail::kCRU, detail::kShifted128);
+  const int32x4_t u_hi = NeonWeigh(b[1], g[1], r[1], detail::kCBU, detail::kCGU, detail::kCRU, detail::kShifted128);
+  const int32x4_t v_lo = NeonWeigh(b[0], g[0], r[0], detail::kCBV, detail::kCGV, detail::kCBU, detail::kShifted128);
+  const int32x4_t v_hi = NeonWeigh(b[1], g[1], r[1], detail::kCBV, detail::kCGV, detail::kCBU, detail::kShifted128);
+
+  *u_out = NeonPackU8(u_lo, u_hi);
+  *v_out = NeonPackU8(v_lo, v_hi);
+}
+
+void BgrToI420Neon(
+  const uint8_t *bgr,
+  const std::size_t bgr_stride,
+  uint8_t *y,
+  const std::size_t y_stride,
+  uint8_t *u,
+  const std::size_t u_stride,
+  uint8_t *v,
+  const std::size_t v_stride,
+  const int width,
+  const int height)
+{
+  const int simd_width = width & ~15;
+
+  for (int row = 0; row < height; row += 2) {
+    const uint8_t *bgr0 = bgr + static_cast<std::size_t>(row) * bgr_stride;
+    const uint8_t *bgr1 = bgr0 + bgr_stride;
+    uint8_t *y0 = y + static_cast<std::size_t>(row) * y_stride;
+    uint8_t *y1 = y0 + y_stride;
+    uint8_t *u_row = u + static_cast<std::size_t>(row / 2) * u_stride;
+    uint8_t *v_row = v + static_cast<std::size_t>(row / 2) * v_stride;
+
+    for (int col = 0; col < simd_width; col += 16) {
+      const uint8x16x3_t top = vld3q_u8(bgr0 + 3 * col);
+      const uint8x16x3_t bottom = vld3q_u8(bgr1 + 3 * col);
+      vst1q_u8(y0 + col, NeonBgrRowToY(top));
+      vst1q_u8(y1 + col, NeonBgrRowToY(bottom));
+
+      uint8x8_t u8;
+      uint8x8_t v8;
+      NeonBgrRowToUv(top, &u8, &v8);
+      vst1_u8(u_row + col / 2, u8);
+      vst1_u8(v_row + col / 2, v8);
+    }
+
+    for (int col = simd_width; col < width; col += 2) {
+      const uint8_t *p00 = bgr0 + 3 * col;
+      const uint8_t *p01 = p00 + 3;
+      const uint8_t *p10 = bgr1 + 3 * col;
+      const uint8_t *p11 = p10 + 3;
+      y0[col] = BgrPixelToY(p00[0], p00[1], p00[2]);
+      y0[col + 1] = BgrPixelToY(p01[0], p01[1], p01[2]);
+      y1[col] = BgrPixelToY(p10[0], p10[1], p10[2]);
+      y1[col + 1] = BgrPixelToY(p11[0], p11[1], p11[2]);
+      u_row[col / 2] = BgrPixelToU(p00[0], p00[1], p00[2]);
+      v_row[col / 2] = BgrPixelToV(p00[0], p00[1], p00[2]);
+    }
+  }
+}
+
+void BgrToNv12Neon(
+  const uint8_t *bgr,
+  const std::size_t bgr_stride,
+  uint8_t *y,
+  const std::size_t y_stride,
+  uint8_t *uv,
+  const std::size_t uv_stride,
+  const int width,
+  const int height)
+{
+  const int simd_width = width & ~15;
+
+  for (int row = 0; row < height; row += 2) {
+    const uint8_t *bgr0 = bgr + static_cast<std::size_t>(row) * bgr_stride;
+    const uint8_t *bgr1 = bgr0 + bgr_stride;
+    uint8_t *y0 = y + static_cast<std::size_t>(row) * y_stride;
+    uint8_t *y1 = y0 + y_stride;
+    uint8_t *uv_row = uv + static_cast<std::size_t>(row / 2) * uv_stride;
+
+    for (int col = 0; col < simd_width; col += 16) {
+      const uint8x16x3_t top = vld3q_u8(bgr0 + 3 * col);
+      const uint8x16x3_t bottom = vld3q_u8(bgr1 + 3 * col);
+      vst1q_u8(y0 + col, NeonBgrRowToY(top));
+      vst1q_u8(y1 + col, NeonBgrRowToY(bottom));
+
+      uint8x8x2_t interleaved;
+      NeonBgrRowToUv(top, &interleaved.val[0], &interleaved.val[1]);
+      vst2_u8(uv_row + col, interleaved);
+    }
+
+    for (int col = simd_width; col < width; col += 2) {
+      const uint8_t *p00 = bgr0 + 3 * col;
+      const uint8_t *p01 = p00 + 3;
+      const uint8_t *p10 = bgr1 + 3 * col;
+      const uint8_t *p11 = p10 + 3;
+      y0[col] = BgrPixelToY(p00[0], p00[1], p00[2]);
+      y0[col + 1] = BgrPixelToY(p01[0], p01[1], p01[2]);
+      y1[col] = BgrPixelToY(p10[0], p10[1], p10[2]);
+      y1[col + 1] = BgrPixelToY(p11[0], p11[1], p11[2]);
+      uv_row[col] = BgrPixelToU(p00[0], p00[1], p00[2]);
+      uv_row[col + 1] = BgrPixelToV(p00[0], p00[1], p00[2]);
+    }
+  }
+}
+
+#endif // YUV_CONVERT_HAVE_NEON
+
+struct KernelTable {
+  void (*i420_to_bgr)(
+    const uint8_t *, std::size_t, const uint8_t *, std::size_t, const uint8_t *, std::size_t, uint8_t *, std::size_t,
+    int, int);
+  void (*bgr_to_i420)(
+    const uint8_t *, std::size_t, uint8_t *, std::size_t, uint8_t *, std::size_t, uint8_t *, std::size_t, int, int);
+  void (*bgr_to_nv12)(const uint8_t *, std::size_t, uint8_t *, std::size_t, uint8_t *, std::size_t, int, int);
+  void (*narrow_10_to_8)(const uint16_t *, std::size_t, uint8_t *, std::size_t, int, int, int);
+  const char *name;
+};
+
+const KernelTable &ActiveKernels()
+{
+  static const KernelTable table = [] {
+    if (detail::HaveAvx2Kernels()) {
+      return KernelTable {
+        detail::I420ToBgrAvx2, detail::BgrToI420Avx2, detail::BgrToNv12Avx2, detail::Narrow10To8Avx2, "avx2"};
+    }
+#if defined(YUV_CONVERT_HAVE_NEON)
+    return KernelTable {I420ToBgrNeon, BgrToI420Neon, BgrToNv12Neon, Narrow10To8Neon, "neon"};
+#else
+    return KernelTable {I420ToBgrScalar, BgrToI420Scalar, BgrToNv12Scalar, Narrow10To8Scalar, "scalar"};
+#endif
+  }();
+  return table;
+}
+
+} // namespace
+
+void I420ToBgr(
+  const uint8_t *y,
+  const std::size_t y_stride,
+  const uint8_t *u,
+  const std::size_t u_stride,
+  const uint8_t *v,
+  const std::size_t v_stride,
+  uint8_t *bgr,
+  const std::size_t bgr_stride,
+  const int width,
+  const int height)
+{
+  ActiveKernels().i420_to_bgr(y, y_stride, u, u_stride, v, v_stride, bgr, bgr_stride, width, height);
+}
+
+void BgrToI420(
+  const uint8_t *bgr,
+  const std::size_t bgr_stride,
+  uint8_t *y,
+  const std::size_t y_stride,
+  uint8_t *u,
+  const std::size_t u_stride,
+  uint8_t *v,
+  const std::size_t v_stride,
+  const int width,
+  const int height)
+{
+  ActiveKernels().bgr_to_i420(bgr, bgr_stride, y, y_stride, u, u_stride, v, v_stride, width, height);
+}
+
+void BgrToNv12(
+  const uint8_t *bgr,
+  const std::size_t bgr_stride,
+  uint8_t *y,
+  const std::size_t y_stride,
+  uint8_t *uv,
+  const std::size_t uv_stride,
+  const int width,
+  const int height)
+{
+  ActiveKernels().bgr_to_nv12(bgr, bgr_stride, y, y_stride, uv, uv_stride, width, height);
+}
+
+void Narrow10To8(
+  const uint16_t *src,
+  const std::size_t src_stride,
+  uint8_t *dst,
+  const std::size_t dst_stride,
+  const int samples_per_row,
+  const int rows,
+  const int shift)
+{
+  ActiveKernels().narrow_10_to_8(src, src_stride, dst, dst_stride, samples_per_row, rows, shift);
+}
+
+void Widen8To10(
+  const uint8_t *src,
+  const std::size_t src_stride,
+  uint16_t *dst,
+  const std::size_t dst_stride,
+  const int samples_per_row,
+  const int rows,
+  const int shift)
+{
+  for (int row = 0; row < rows; ++row) {
+    const uint8_t *src_row = src + static_cast<std::size_t>(row) * src_stride;
+    uint16_t *dst_row =
+      reinterpret_cast<uint16_t *>(reinterpret_cast<uint8_t *>(dst) + static_cast<std::size_t>(row) * dst_stride);
+    for (int col = 0; col < samples_per_row; ++col) {
+      dst_row[col] = static_cast<uint16_t>(src_row[col] << shift);
+    }
+  }
+}
+
+void BgrToYuy2(
+  const uint8_t *bgr,
+  const std::size_t bgr_stride,
+  uint8_t *yuy2,
+  const std::size_t yuy2_stride,
+  const int width,
+  const int height)
+{
+  for (int row = 0; row < height; ++row) {
+    const uint8_t *src = bgr + static_cast<std::size_t>(row) * bgr_stride;
+    uint8_t *dst = yuy2 + static_cast<std::size_t>(row) * yuy2_stride;
+
+    for (int col = 0; col < width; col += 2) {
+      const uint8_t *p0 = src + 3 * col;
+      const uint8_t *p1 = p0 + 3;
+      // Chroma is averaged over the horizontal pixel pair.
+      const int b = (p0[0] + p1[0] + 1) / 2;
+      const int g = (p0[1] + p1[1] + 1) / 2;
+      const int r = (p0[2] + p1[2] + 1) / 2;
+
+      dst[2 * col] = BgrPixelToY(p0[0], p0[1], p0[2]);
+      dst[2 * col + 1] = BgrPixelToU(b, g, r);
+      dst[2 * col + 2] = BgrPixelToY(p1[0], p1[1], p1[2]);
+      dst[2 * col + 3] = BgrPixelToV(b, g, r);
+    }
+  }
+}
+
+void BgrToUyvy(
+  const uint8_t *bgr,
+  const std::size_t bgr_stride,
+  uint8_t *uyvy,
+  const std::size_t uyvy_stride,
+  const int width,
+  const int height)
+{
+  for (int row = 0; row < height; ++row) {
+    const uint8_t *src = bgr + static_cast<std::size_t>(row) * bgr_stride;
+    uint8_t *dst = uyvy + static_cast<std::size_t>(row) * uyvy_stride;
+
+    for (int col = 0; col < width; col += 2) {
+      const uint8_t *p0 = src + 3 * col;
+      const uint8_t *p1 = p0 + 3;
+      const int b = (p0[0] + p1[0] + 1) / 2;
+      const int g = (p0[1] + p1[1] + 1) / 2;
+      const int r = (p0[2] + p1[2] + 1) / 2;
+
+      dst[2 * col] = BgrPixelToU(b, g, r);
+      dst[2 * col + 1] = BgrPixelToY(p0[0], p0[1], p0[2]);
+      dst[2 * col + 2] = BgrPixelToV(b, g, r);
+      dst[2 * col + 3] = BgrPixelToY(p1[0], p1[1], p1[2]);
+    }
+  }
+}
+
+const char *ActiveKernelSet()
+{
+  return ActiveKernels().name;
+}
+
+} // namespace yuv_convert
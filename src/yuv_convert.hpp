@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Strided YUV<->BGR conversion kernels that operate directly on OBS frame
+// planes, so no linear staging buffers are needed on either side of the
+// pipeline. All kernels use OpenCV's ITU-R BT.601 studio-swing fixed-point
+// math, keeping output interchangeable with the cv::cvtColor paths they
+// replace. Widths and heights must be even for the subsampled formats.
+namespace yuv_convert {
+
+void I420ToBgr(
+  const uint8_t *y,
+  std::size_t y_stride,
+  const uint8_t *u,
+  std::size_t u_stride,
+  const uint8_t *v,
+  std::size_t v_stride,
+  uint8_t *bgr,
+  std::size_t bgr_stride,
+  int width,
+  int height);
+
+void BgrToI420(
+  const uint8_t *bgr,
+  std::size_t bgr_stride,
+  uint8_t *y,
+  std::size_t y_stride,
+  uint8_t *u,
+  std::size_t u_stride,
+  uint8_t *v,
+  std::size_t v_stride,
+  int width,
+  int height);
+
+void BgrToNv12(
+  const uint8_t *bgr,
+  std::size_t bgr_stride,
+  uint8_t *y,
+  std::size_t y_stride,
+  uint8_t *uv,
+  std::size_t uv_stride,
+  int width,
+  int height);
+
+// Narrows 10-bit samples stored in 16-bit words to 8 bits by dropping the low
+// bits. shift is 2 for low-aligned samples (I010) and 8 for MSB-aligned
+// samples (P010). samples_per_row counts 16-bit words, so an interleaved
+// P010 chroma plane passes its full word count, not its pixel width.
+void Narrow10To8(
+  const uint16_t *src,
+  std::size_t src_stride,
+  uint8_t *dst,
+  std::size_t dst_stride,
+  int samples_per_row,
+  int rows,
+  int shift);
+
+// Inverse of Narrow10To8 for overlay write-back; scalar only, since it runs
+// on the dirty regions rather than whole frames.
+void Widen8To10(
+  const uint8_t *src,
+  std::size_t src_stride,
+  uint16_t *dst,
+  std::size_t dst_stride,
+  int samples_per_row,
+  int rows,
+  int shift);
+
+void BgrToYuy2(const uint8_t *bgr, std::size_t bgr_stride, uint8_t *yuy2, std::size_t yuy2_stride, int width, int height);
+
+void BgrToUyvy(const uint8_t *bgr, std::size_t bgr_stride, uint8_t *uyvy, std::size_t uyvy_stride, int width, int height);
+
+// Name of the kernel set selected at runtime: "avx2", "neon" or "scalar".
+const char *ActiveKernelSet();
+
+} // namespace yuv_convert
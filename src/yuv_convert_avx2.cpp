@@ -0,0 +1,445 @@
+// AVX2 kernel set for yuv_convert. This translation unit is compiled with
+// AVX2 code generation enabled (see CMakeLists.txt); nothing here may be
+// called unless HaveAvx2Kernels() returned true at runtime.
+
+#include "yuv_convert.hpp"
+#include "yuv_convert_detail.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define YUV_CONVERT_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace yuv_convert::detail {
+
+#if defined(YUV_CONVERT_X86)
+
+namespace {
+
+bool DetectAvx2()
+{
+#if defined(_MSC_VER)
+  int info[4] = {0, 0, 0, 0};
+  __cpuid(info, 0);
+  if (info[0] < 7) {
+    return false;
+  }
+  __cpuid(info, 1);
+  const bool osxsave = (info[2] & (1 << 27)) != 0;
+  const bool avx = (info[2] & (1 << 28)) != 0;
+  if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+    return false;
+  }
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+// Widens 16 bytes into two vectors of 8 32-bit lanes.
+inline void Widen16(const __m128i bytes, __m256i *lo, __m256i *hi)
+{
+  *lo = _mm256_cvtepu8_epi32(bytes);
+  *hi = _mm256_cvtepu8_epi32(_mm_srli_si128(bytes, 8));
+}
+
+// Packs two vectors of 8 32-bit lanes back into 16 saturated bytes.
+inline __m128i Pack16(const __m256i lo, const __m256i hi)
+{
+  __m256i packed = _mm256_packs_epi32(lo, hi);
+  packed = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+  return _mm_packus_epi16(_mm256_castsi256_si128(packed), _mm256_extracti128_si256(packed, 1));
+}
+
+constexpr char Z = static_cast<char>(0x80);
+
+// Interleaves separate B/G/R byte vectors (16 pixels) into 48 bytes of BGR24.
+inline void StoreBgr16(uint8_t *dst, const __m128i b, const __m128i g, const __m128i r)
+{
+  const __m128i mb0 = _mm_setr_epi8(0, Z, Z, 1, Z, Z, 2, Z, Z, 3, Z, Z, 4, Z, Z, 5);
+  const __m128i mg0 = _mm_setr_epi8(Z, 0, Z, Z, 1, Z, Z, 2, Z, Z, 3, Z, Z, 4, Z, Z);
+  const __m128i mr0 = _mm_setr_epi8(Z, Z, 0, Z, Z, 1, Z, Z, 2, Z, Z, 3, Z, Z, 4, Z);
+  const __m128i mb1 = _mm_setr_epi8(Z, Z, 6, Z, Z, 7, Z, Z, 8, Z, Z, 9, Z, Z, 10, Z);
+  const __m128i mg1 = _mm_setr_epi8(5, Z, Z, 6, Z, Z, 7, Z, Z, 8, Z, Z, 9, Z, Z, 10);
+  const __m128i mr1 = _mm_setr_epi8(Z, 5, Z, Z, 6, Z, Z, 7, Z, Z, 8, Z, Z, 9, Z, Z);
+  const __m128i mb2 = _mm_setr_epi8(Z, 11, Z, Z, 12, Z, Z, 13, Z, Z, 14, Z, Z, 15, Z, Z);
+  const __m128i mg2 = _mm_setr_epi8(Z, Z, 11, Z, Z, 12, Z, Z, 13, Z, Z, 14, Z, Z, 15, Z);
+  const __m128i mr2 = _mm_setr_epi8(10, Z, Z, 11, Z, Z, 12, Z, Z, 13, Z, Z, 14, Z, Z, 15);
+
+  const __m128i out0 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(b, mb0), _mm_shuffle_epi8(g, mg0)),
+                                    _mm_shuffle_epi8(r, mr0));
+  const __m128i out1 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(b, mb1), _mm_shuffle_epi8(g, mg1)),
+                                    _mm_shuffle_epi8(r, mr1));
+  const __m128i out2 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(b, mb2), _mm_shuffle_epi8(g, mg2)),
+                                    _mm_shuffle_epi8(r, mr2));
+
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), out0);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16), out1);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 32), out2);
+}
+
+// Deinterleaves 48 bytes of BGR24 (16 pixels) into separate B/G/R byte vectors.
+inline void LoadBgr16(const uint8_t *src, __m128i *b, __m128i *g, __m128i *r)
+{
+  const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+  const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16));
+  const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 32));
+
+  const __m128i mb0 = _mm_setr_epi8(0, 3, 6, 9, 12, 15, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z);
+  const __m128i mb1 = _mm_setr_epi8(Z, Z, Z, Z, Z, Z, 2, 5, 8, 11, 14, Z, Z, Z, Z, Z);
+  const __m128i mb2 = _mm_setr_epi8(Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, 1, 4, 7, 10, 13);
+  const __m128i mg0 = _mm_setr_epi8(1, 4, 7, 10, 13, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z);
+  const __m128i mg1 = _mm_setr_epi8(Z, Z, Z, Z, Z, 0, 3, 6, 9, 12, 15, Z, Z, Z, Z, Z);
+  const __m128i mg2 = _mm_setr_epi8(Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, 2, 5, 8, 11, 14);
+  const __m128i mr0 = _mm_setr_epi8(2, 5, 8, 11, 14, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z);
+  const __m128i mr1 = _mm_setr_epi8(Z, Z, Z, Z, Z, 1, 4, 7, 10, 13, Z, Z, Z, Z, Z, Z);
+  const __m128i mr2 = _mm_setr_epi8(Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, 0, 3, 6, 9, 12, 15);
+
+  *b = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(v0, mb0), _mm_shuffle_epi8(v1, mb1)), _mm_shuffle_epi8(v2, mb2));
+  *g = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(v0, mg0), _mm_shuffle_epi8(v1, mg1)), _mm_shuffle_epi8(v2, mg2));
+  *r = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(v0, mr0), _mm_shuffle_epi8(v1, mr1)), _mm_shuffle_epi8(v2, mr2));
+}
+
+inline __m256i MulAddShift(const __m256i luma, const __m256i chroma_sum)
+{
+  const __m256i half = _mm256_set1_epi32(kHalf);
+  return _mm256_srai_epi32(_mm256_add_epi32(_mm256_add_epi32(luma, chroma_sum), half), kShift);
+}
+
+struct ChromaDiff {
+  __m256i u_lo;
+  __m256i u_hi;
+  __m256i v_lo;
+  __m256i v_hi;
+};
+
+// Loads 8 U and 8 V samples and duplicates each across its 2-pixel span,
+// widened to 32-bit lanes minus the 128 bias.
+inline ChromaDiff LoadChroma16(const uint8_t *u_row, const uint8_t *v_row)
+{
+  const __m128i bias = _mm_set1_epi16(128);
+  const __m128i u16 = _mm_sub_epi16(_mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(u_row))), bias);
+  const __m128i v16 = _mm_sub_epi16(_mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(v_row))), bias);
+
+  ChromaDiff diff;
+  diff.u_lo = _mm256_cvtepi16_epi32(_mm_unpacklo_epi16(u16, u16));
+  diff.u_hi = _mm256_cvtepi16_epi32(_mm_unpackhi_epi16(u16, u16));
+  diff.v_lo = _mm256_cvtepi16_epi32(_mm_unpacklo_epi16(v16, v16));
+  diff.v_hi = _mm256_cvtepi16_epi32(_mm_unpackhi_epi16(v16, v16));
+  return diff;
+}
+
+// Converts one luma row of 16 pixels against prepared chroma differences.
+inline void YuvRowToBgr16(const uint8_t *y_row, const ChromaDiff &diff, uint8_t *dst)
+{
+  const __m256i c16 = _mm256_set1_epi32(16);
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i ccy = _mm256_set1_epi32(kCY);
+  const __m256i ccub = _mm256_set1_epi32(kCUB);
+  const __m256i ccug = _mm256_set1_epi32(kCUG);
+  const __m256i ccvg = _mm256_set1_epi32(kCVG);
+  const __m256i ccvr = _mm256_set1_epi32(kCVR);
+
+  __m256i y_lo;
+  __m256i y_hi;
+  Widen16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(y_row)), &y_lo, &y_hi);
+  const __m256i luma_lo = _mm256_mullo_epi32(_mm256_max_epi32(_mm256_sub_epi32(y_lo, c16), zero), ccy);
+  const __m256i luma_hi = _mm256_mullo_epi32(_mm256_max_epi32(_mm256_sub_epi32(y_hi, c16), zero), ccy);
+
+  const __m256i b_lo = MulAddShift(luma_lo, _mm256_mullo_epi32(diff.u_lo, ccub));
+  const __m256i b_hi = MulAddShift(luma_hi, _mm256_mullo_epi32(diff.u_hi, ccub));
+  const __m256i g_lo = MulAddShift(
+    luma_lo, _mm256_add_epi32(_mm256_mullo_epi32(diff.u_lo, ccug), _mm256_mullo_epi32(diff.v_lo, ccvg)));
+  const __m256i g_hi = MulAddShift(
+    luma_hi, _mm256_add_epi32(_mm256_mullo_epi32(diff.u_hi, ccug), _mm256_mullo_epi32(diff.v_hi, ccvg)));
+  const __m256i r_lo = MulAddShift(luma_lo, _mm256_mullo_epi32(diff.v_lo, ccvr));
+  const __m256i r_hi = MulAddShift(luma_hi, _mm256_mullo_epi32(diff.v_hi, ccvr));
+
+  StoreBgr16(dst, Pack16(b_lo, b_hi), Pack16(g_lo, g_hi), Pack16(r_lo, r_hi));
+}
+
+inline __m256i Weigh(
+  const __m256i b,
+  const __m256i g,
+  const __m256i r,
+  const int cb,
+  const int cg,
+  const int cr,
+  const int bias)
+{
+  __m256i sum = _mm256_mullo_epi32(r, _mm256_set1_epi32(cr));
+  sum = _mm256_add_epi32(sum, _mm256_mullo_epi32(g, _mm256_set1_epi32(cg)));
+  sum = _mm256_add_epi32(sum, _mm256_mullo_epi32(b, _mm256_set1_epi32(cb)));
+  sum = _mm256_add_epi32(sum, _mm256_set1_epi32(kHalf + bias));
+  return _mm256_srai_epi32(sum, kShift);
+}
+
+// Even 32-bit lanes of two vectors combined into one vector of 8 lanes.
+inline __m256i EvenLanes(const __m256i lo, const __m256i hi)
+{
+  const __m256i idx = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+  const __m128i even_lo = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(lo, idx));
+  const __m128i even_hi = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(hi, idx));
+  return _mm256_set_m128i(even_hi, even_lo);
+}
+
+struct WidenedBgr {
+  __m256i b_lo;
+  __m256i b_hi;
+  __m256i g_lo;
+  __m256i g_hi;
+  __m256i r_lo;
+  __m256i r_hi;
+};
+
+inline WidenedBgr LoadWidenedBgr16(const uint8_t *src)
+{
+  __m128i b;
+  __m128i g;
+  __m128i r;
+  LoadBgr16(src, &b, &g, &r);
+
+  WidenedBgr out;
+  Widen16(b, &out.b_lo, &out.b_hi);
+  Widen16(g, &out.g_lo, &out.g_hi);
+  Widen16(r, &out.r_lo, &out.r_hi);
+  return out;
+}
+
+inline __m128i BgrRowToY16(const WidenedBgr &px)
+{
+  const __m256i y_lo = Weigh(px.b_lo, px.g_lo, px.r_lo, kCBY, kCGY, kCRY, kShifted16);
+  const __m256i y_hi = Weigh(px.b_hi, px.g_hi, px.r_hi, kCBY, kCGY, kCRY, kShifted16);
+  return Pack16(y_lo, y_hi);
+}
+
+// Chroma for 16 pixels of the top row: 8 U and 8 V bytes from even columns,
+// returned in the low halves of the outputs.
+inline void BgrRowToUv8(const WidenedBgr &px, __m128i *u_out, __m128i *v_out)
+{
+  const __m256i b_even = EvenLanes(px.b_lo, px.b_hi);
+  const __m256i g_even = EvenLanes(px.g_lo, px.g_hi);
+  const __m256i r_even = EvenLanes(px.r_lo, px.r_hi);
+
+  const __m256i u32 = Weigh(b_even, g_even, r_even, kCBU, kCGU, kCRU, kShifted128);
+  const __m256i v32 = Weigh(b_even, g_even, r_even, kCBV, kCGV, kCBU, kShifted128);
+
+  // Only 8 lanes are meaningful; pack them into the low 8 bytes.
+  __m256i u16 = _mm256_packs_epi32(u32, u32);
+  u16 = _mm256_permute4x64_epi64(u16, _MM_SHUFFLE(3, 1, 2, 0));
+  *u_out = _mm_packus_epi16(_mm256_castsi256_si128(u16), _mm256_castsi256_si128(u16));
+
+  __m256i v16 = _mm256_packs_epi32(v32, v32);
+  v16 = _mm256_permute4x64_epi64(v16, _MM_SHUFFLE(3, 1, 2, 0));
+  *v_out = _mm_packus_epi16(_mm256_castsi256_si128(v16), _mm256_castsi256_si128(v16));
+}
+
+} // namespace
+
+bool HaveAvx2Kernels()
+{
+  static const bool available = DetectAvx2();
+  return available;
+}
+
+void I420ToBgrAvx2(
+  const uint8_t *y,
+  const std::size_t y_stride,
+  const uint8_t *u,
+  const std::size_t u_stride,
+  const uint8_t *v,
+  const std::size_t v_stride,
+  uint8_t *bgr,
+  const std::size_t bgr_stride,
+  const int width,
+  const int height)
+{
+  const int simd_width = width & ~15;
+
+  for (int row = 0; row < height; row += 2) {
+    const uint8_t *y0 = y + static_cast<std::size_t>(row) * y_stride;
+    const uint8_t *y1 = y0 + y_stride;
+    const uint8_t *u_row = u + static_cast<std::size_t>(row / 2) * u_stride;
+    const uint8_t *v_row = v + static_cast<std::size_t>(row / 2) * v_stride;
+    uint8_t *bgr0 = bgr + static_cast<std::size_t>(row) * bgr_stride;
+    uint8_t *bgr1 = bgr0 + bgr_stride;
+
+    for (int col = 0; col < simd_width; col += 16) {
+      const ChromaDiff diff = LoadChroma16(u_row + col / 2, v_row + col / 2);
+      YuvRowToBgr16(y0 + col, diff, bgr0 + 3 * col);
+      YuvRowToBgr16(y1 + col, diff, bgr1 + 3 * col);
+    }
+
+    for (int col = simd_width; col < width; col += 2) {
+      const int d_u = u_row[col / 2] - 128;
+      const int d_v = v_row[col / 2] - 128;
+      YuvToBgrPixel(y0[col], d_u, d_v, bgr0 + 3 * col);
+      YuvToBgrPixel(y0[col + 1], d_u, d_v, bgr0 + 3 * (col + 1));
+      YuvToBgrPixel(y1[col], d_u, d_v, bgr1 + 3 * col);
+      YuvToBgrPixel(y1[col + 1], d_u, d_v, bgr1 + 3 * (col + 1));
+    }
+  }
+}
+
+void BgrToI420Avx2(
+  const uint8_t *bgr,
+  const std::size_t bgr_stride,
+  uint8_t *y,
+  const std::size_t y_stride,
+  uint8_t *u,
+  const std::size_t u_stride,
+  uint8_t *v,
+  const std::size_t v_stride,
+  const int width,
+  const int height)
+{
+  const int simd_width = width & ~15;
+
+  for (int row = 0; row < height; row += 2) {
+    const uint8_t *bgr0 = bgr + static_cast<std::size_t>(row) * bgr_stride;
+    const uint8_t *bgr1 = bgr0 + bgr_stride;
+    uint8_t *y0 = y + static_cast<std::size_t>(row) * y_stride;
+    uint8_t *y1 = y0 + y_stride;
+    uint8_t *u_row = u + static_cast<std::size_t>(row / 2) * u_stride;
+    uint8_t *v_row = v + static_cast<std::size_t>(row / 2) * v_stride;
+
+    for (int col = 0; col < simd_width; col += 16) {
+      const WidenedBgr top = LoadWidenedBgr16(bgr0 + 3 * col);
+      const WidenedBgr bottom = LoadWidenedBgr16(bgr1 + 3 * col);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(y0 + col), BgrRowToY16(top));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(y1 + col), BgrRowToY16(bottom));
+
+      __m128i u8;
+      __m128i v8;
+      BgrRowToUv8(top, &u8, &v8);
+      _mm_storel_epi64(reinterpret_cast<__m128i *>(u_row + col / 2), u8);
+      _mm_storel_epi64(reinterpret_cast<__m128i *>(v_row + col / 2), v8);
+    }
+
+    for (int col = simd_width; col < width; col += 2) {
+      const uint8_t *p00 = bgr0 + 3 * col;
+      const uint8_t *p01 = p00 + 3;
+      const uint8_t *p10 = bgr1 + 3 * col;
+      const uint8_t *p11 = p10 + 3;
+      y0[col] = BgrPixelToY(p00[0], p00[1], p00[2]);
+      y0[col + 1] = BgrPixelToY(p01[0], p01[1], p01[2]);
+      y1[col] = BgrPixelToY(p10[0], p10[1], p10[2]);
+      y1[col + 1] = BgrPixelToY(p11[0], p11[1], p11[2]);
+      u_row[col / 2] = BgrPixelToU(p00[0], p00[1], p00[2]);
+      v_row[col / 2] = BgrPixelToV(p00[0], p00[1], p00[2]);
+    }
+  }
+}
+
+void BgrToNv12Avx2(
+  const uint8_t *bgr,
+  const std::size_t bgr_stride,
+  uint8_t *y,
+  const std::size_t y_stride,
+  uint8_t *uv,
+  const std::size_t uv_stride,
+  const int width,
+  const int height)
+{
+  const int simd_width = width & ~15;
+
+  for (int row = 0; row < height; row += 2) {
+    const uint8_t *bgr0 = bgr + static_cast<std::size_t>(row) * bgr_stride;
+    const uint8_t *bgr1 = bgr0 + bgr_stride;
+    uint8_t *y0 = y + static_cast<std::size_t>(row) * y_stride;
+    uint8_t *y1 = y0 + y_stride;
+    uint8_t *uv_row = uv + static_cast<std::size_t>(row / 2) * uv_stride;
+
+    for (int col = 0; col < simd_width; col += 16) {
+      const WidenedBgr top = LoadWidenedBgr16(bgr0 + 3 * col);
+      const WidenedBgr bottom = LoadWidenedBgr16(bgr1 + 3 * col);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(y0 + col), BgrRowToY16(top));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(y1 + col), BgrRowToY16(bottom));
+
+      __m128i u8;
+      __m128i v8;
+      BgrRowToUv8(top, &u8, &v8);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(uv_row + col), _mm_unpacklo_epi8(u8, v8));
+    }
+
+    for (int col = simd_width; col < width; col += 2) {
+      const uint8_t *p00 = bgr0 + 3 * col;
+      const uint8_t *p01 = p00 + 3;
+      const uint8_t *p10 = bgr1 + 3 * col;
+      const uint8_t *p11 = p10 + 3;
+      y0[col] = BgrPixelToY(p00[0], p00[1], p00[2]);
+      y0[col + 1] = BgrPixelToY(p01[0], p01[1], p01[2]);
+      y1[col] = BgrPixelToY(p10[0], p10[1], p10[2]);
+      y1[col + 1] = BgrPixelToY(p11[0], p11[1], p11[2]);
+      uv_row[col] = BgrPixelToU(p00[0], p00[1], p00[2]);
+      uv_row[col + 1] = BgrPixelToV(p00[0], p00[1], p00[2]);
+    }
+  }
+}
+
+void Narrow10To8Avx2(
+  const uint16_t *src,
+  const std::size_t src_stride,
+  uint8_t *dst,
+  const std::size_t dst_stride,
+  const int samples_per_row,
+  const int rows,
+  const int shift)
+{
+  const int simd_width = samples_per_row & ~31;
+  const __m128i shift_count = _mm_cvtsi32_si128(shift);
+
+  for (int row = 0; row < rows; ++row) {
+    const uint16_t *src_row =
+      reinterpret_cast<const uint16_t *>(reinterpret_cast<const uint8_t *>(src) + static_cast<std::size_t>(row) * src_stride);
+    uint8_t *dst_row = dst + static_cast<std::size_t>(row) * dst_stride;
+
+    for (int col = 0; col < simd_width; col += 32) {
+      const __m256i lo =
+        _mm256_srl_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src_row + col)), shift_count);
+      const __m256i hi =
+        _mm256_srl_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src_row + col + 16)), shift_count);
+      // packus interleaves 128-bit halves; permute restores sample order.
+      const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst_row + col), packed);
+    }
+
+    for (int col = simd_width; col < samples_per_row; ++col) {
+      dst_row[col] = static_cast<uint8_t>(src_row[col] >> shift);
+    }
+  }
+}
+
+#else // !YUV_CONVERT_X86
+
+// Non-x86 builds: NEON or scalar kernels are selected in yuv_convert.cpp.
+bool HaveAvx2Kernels()
+{
+  return false;
+}
+
+void I420ToBgrAvx2(const uint8_t *, std::size_t, const uint8_t *, std::size_t, const uint8_t *, std::size_t, uint8_t *,
+                   std::size_t, int, int)
+{
+}
+
+void BgrToI420Avx2(const uint8_t *, std::size_t, uint8_t *, std::size_t, uint8_t *, std::size_t, uint8_t *, std::size_t,
+                   int, int)
+{
+}
+
+void BgrToNv12Avx2(const uint8_t *, std::size_t, uint8_t *, std::size_t, uint8_t *, std::size_t, int, int)
+{
+}
+
+void Narrow10To8Avx2(const uint16_t *, std::size_t, uint8_t *, std::size_t, int, int, int)
+{
+}
+
+#endif
+
+} // namespace yuv_convert::detail
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// Shared fixed-point helpers for the conversion kernels. The constants are
+// OpenCV's 20-bit ITU-R BT.601 studio-swing coefficients, so the scalar
+// reference path and the SIMD paths round identically.
+namespace yuv_convert::detail {
+
+constexpr int kShift = 20;
+constexpr int kHalf = 1 << (kShift - 1);
+
+// YUV -> RGB
+constexpr int kCY = 1220542;  // 1.164
+constexpr int kCUB = 2116026; // 2.018
+constexpr int kCUG = -409993; // -0.391
+constexpr int kCVG = -852492; // -0.813
+constexpr int kCVR = 1673527; // 1.596
+
+// RGB -> YUV
+constexpr int kCRY = 269484;
+constexpr int kCGY = 528482;
+constexpr int kCBY = 102760;
+constexpr int kCRU = -155188;
+constexpr int kCGU = -305135;
+constexpr int kCBU = 460324;
+constexpr int kCGV = -385875;
+constexpr int kCBV = -74448;
+
+constexpr int kShifted16 = 16 << kShift;
+constexpr int kShifted128 = 128 << kShift;
+
+inline uint8_t ClampByte(const int value)
+{
+  return static_cast<uint8_t>(std::clamp(value, 0, 255));
+}
+
+inline void YuvToBgrPixel(const int y, const int d_u, const int d_v, uint8_t *bgr)
+{
+  const int luma = std::max(0, y - 16) * kCY;
+  bgr[0] = ClampByte((luma + kCUB * d_u + kHalf) >> kShift);
+  bgr[1] = ClampByte((luma + kCUG * d_u + kCVG * d_v + kHalf) >> kShift);
+  bgr[2] = ClampByte((luma + kCVR * d_v + kHalf) >> kShift);
+}
+
+inline uint8_t BgrPixelToY(const int b, const int g, const int r)
+{
+  return ClampByte((kCRY * r + kCGY * g + kCBY * b + kHalf + kShifted16) >> kShift);
+}
+
+inline uint8_t BgrPixelToU(const int b, const int g, const int r)
+{
+  return ClampByte((kCRU * r + kCGU * g + kCBU * b + kHalf + kShifted128) >> kShift);
+}
+
+inline uint8_t BgrPixelToV(const int b, const int g, const int r)
+{
+  return ClampByte((kCBU * r + kCGV * g + kCBV * b + kHalf + kShifted128) >> kShift);
+}
+
+} // namespace yuv_convert::detail
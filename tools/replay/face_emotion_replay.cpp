@@ -0,0 +1,497 @@
+// Offline replay harness: memory-maps a recorded raw frame dump and drives it
+// through the same stages FilterVideo runs — extract, SubmitFrame,
+// TryConsumeLatest, overlay draw, write-back — as fast as possible, then
+// reports sustained fps, a per-stage time breakdown and peak RSS. Build with
+// -DENABLE_REPLAY_HARNESS=ON.
+//
+// Dump layout (little-endian):
+//   file header:  char magic[8] = "FERDUMP1", uint32 version = 1, uint32 reserved
+//   per frame:    uint64 timestamp_ns
+//                 uint32 format        (FrameFormat below)
+//                 uint32 width, height
+//                 uint32 linesize[4]
+//                 uint64 data_size     (all planes, contiguous, in plane order)
+//                 uint8  data[data_size]
+//
+// The harness links the worker, tracker and conversion kernels directly; the
+// obs_log stub at the bottom stands in for libobs logging.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <opencv2/imgproc.hpp>
+
+#include <plugin-support.h>
+
+#include "emotion_mapping.hpp"
+#include "inference_worker.hpp"
+#include "yuv_convert.hpp"
+
+namespace {
+
+constexpr char kMagic[8] = {'F', 'E', 'R', 'D', 'U', 'M', 'P', '1'};
+
+enum class FrameFormat : uint32_t {
+  kBgra = 0,
+  kNv12 = 1,
+  kI420 = 2,
+  kYuy2 = 3,
+  kP010 = 4,
+  kI010 = 5,
+};
+
+#pragma pack(push, 1)
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+};
+
+struct FrameHeader {
+  uint64_t timestamp_ns;
+  uint32_t format;
+  uint32_t width;
+  uint32_t height;
+  uint32_t linesize[4];
+  uint64_t data_size;
+};
+#pragma pack(pop)
+
+struct MappedFile {
+  const uint8_t *data = nullptr;
+  std::size_t size = 0;
+#if defined(_WIN32)
+  HANDLE file = INVALID_HANDLE_VALUE;
+  HANDLE mapping = nullptr;
+#else
+  int fd = -1;
+#endif
+
+  bool Open(const char *path)
+  {
+#if defined(_WIN32)
+    file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+      return false;
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+      return false;
+    }
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+      return false;
+    }
+    data = static_cast<const uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    size = static_cast<std::size_t>(file_size.QuadPart);
+    return data != nullptr;
+#else
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat info = {};
+    if (fstat(fd, &info) != 0) {
+      return false;
+    }
+    size = static_cast<std::size_t>(info.st_size);
+    data = static_cast<const uint8_t *>(mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0));
+    return data != MAP_FAILED;
+#endif
+  }
+
+  ~MappedFile()
+  {
+#if defined(_WIN32)
+    if (data != nullptr) {
+      UnmapViewOfFile(data);
+    }
+    if (mapping != nullptr) {
+      CloseHandle(mapping);
+    }
+    if (file != INVALID_HANDLE_VALUE) {
+      CloseHandle(file);
+    }
+#else
+    if (data != nullptr && data != MAP_FAILED) {
+      munmap(const_cast<uint8_t *>(data), size);
+    }
+    if (fd >= 0) {
+      close(fd);
+    }
+#endif
+  }
+};
+
+struct FrameView {
+  FrameHeader header;
+  const uint8_t *planes[4] = {nullptr, nullptr, nullptr, nullptr};
+};
+
+// Plane offsets follow from the strides and dimensions, matching how OBS lays
+// frames out in obs_source_frame.
+bool ResolvePlanes(FrameView *view, const uint8_t *payload, const uint64_t payload_size)
+{
+  const FrameHeader &h = view->header;
+  const std::size_t height = h.height;
+  std::size_t offsets[4] = {0, 0, 0, 0};
+  std::size_t total = 0;
+
+  switch (static_cast<FrameFormat>(h.format)) {
+  case FrameFormat::kBgra:
+  case FrameFormat::kYuy2:
+    total = static_cast<std::size_t>(h.linesize[0]) * height;
+    break;
+  case FrameFormat::kNv12:
+  case FrameFormat::kP010:
+    offsets[1] = static_cast<std::size_t>(h.linesize[0]) * height;
+    total = offsets[1] + static_cast<std::size_t>(h.linesize[1]) * (height / 2);
+    break;
+  case FrameFormat::kI420:
+  case FrameFormat::kI010:
+    offsets[1] = static_cast<std::size_t>(h.linesize[0]) * height;
+    offsets[2] = offsets[1] + static_cast<std::size_t>(h.linesize[1]) * (height / 2);
+    total = offsets[2] + static_cast<std::size_t>(h.linesize[2]) * (height / 2);
+    break;
+  default:
+    return false;
+  }
+
+  if (total > payload_size) {
+    return false;
+  }
+  for (int plane = 0; plane < 4; ++plane) {
+    view->planes[plane] = offsets[plane] != 0 || plane == 0 ? payload + offsets[plane] : nullptr;
+  }
+  return true;
+}
+
+// Mirrors FaceEmotionFilter::ExtractBgrFrame for the dump formats.
+bool ExtractBgr(const FrameView &view, cv::Mat *bgr)
+{
+  const int width = static_cast<int>(view.header.width);
+  const int height = static_cast<int>(view.header.height);
+  const FrameHeader &h = view.header;
+
+  switch (static_cast<FrameFormat>(h.format)) {
+  case FrameFormat::kBgra: {
+    const cv::Mat bgra(height, width, CV_8UC4, const_cast<uint8_t *>(view.planes[0]), h.linesize[0]);
+    cv::cvtColor(bgra, *bgr, cv::COLOR_BGRA2BGR);
+    return true;
+  }
+  case FrameFormat::kNv12: {
+    const cv::Mat y(height, width, CV_8UC1, const_cast<uint8_t *>(view.planes[0]), h.linesize[0]);
+    const cv::Mat uv(height / 2, width / 2, CV_8UC2, const_cast<uint8_t *>(view.planes[1]), h.linesize[1]);
+    cv::cvtColorTwoPlane(y, uv, *bgr, cv::COLOR_YUV2BGR_NV12);
+    return true;
+  }
+  case FrameFormat::kI420: {
+    bgr->create(height, width, CV_8UC3);
+    yuv_convert::I420ToBgr(
+      view.planes[0], h.linesize[0], view.planes[1], h.linesize[1], view.planes[2], h.linesize[2], bgr->data,
+      bgr->step, width, height);
+    return true;
+  }
+  case FrameFormat::kYuy2: {
+    const cv::Mat yuy2(height, width, CV_8UC2, const_cast<uint8_t *>(view.planes[0]), h.linesize[0]);
+    cv::cvtColor(yuy2, *bgr, cv::COLOR_YUV2BGR_YUY2);
+    return true;
+  }
+  case FrameFormat::kP010: {
+    cv::Mat y8(height, width, CV_8UC1);
+    cv::Mat uv8(height / 2, width / 2, CV_8UC2);
+    yuv_convert::Narrow10To8(
+      reinterpret_cast<const uint16_t *>(view.planes[0]), h.linesize[0], y8.data, y8.step, width, height, 8);
+    yuv_convert::Narrow10To8(
+      reinterpret_cast<const uint16_t *>(view.planes[1]), h.linesize[1], uv8.data, uv8.step, width, height / 2, 8);
+    cv::cvtColorTwoPlane(y8, uv8, *bgr, cv::COLOR_YUV2BGR_NV12);
+    return true;
+  }
+  case FrameFormat::kI010: {
+    cv::Mat y8(height, width, CV_8UC1);
+    cv::Mat u8(height / 2, width / 2, CV_8UC1);
+    cv::Mat v8(height / 2, width / 2, CV_8UC1);
+    yuv_convert::Narrow10To8(
+      reinterpret_cast<const uint16_t *>(view.planes[0]), h.linesize[0], y8.data, y8.step, width, height, 2);
+    yuv_convert::Narrow10To8(
+      reinterpret_cast<const uint16_t *>(view.planes[1]), h.linesize[1], u8.data, u8.step, width / 2, height / 2, 2);
+    yuv_convert::Narrow10To8(
+      reinterpret_cast<const uint16_t *>(view.planes[2]), h.linesize[2], v8.data, v8.step, width / 2, height / 2, 2);
+    bgr->create(height, width, CV_8UC3);
+    yuv_convert::I420ToBgr(
+      y8.data, y8.step, u8.data, u8.step, v8.data, v8.step, bgr->data, bgr->step, width, height);
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+// Overlay + write-back stand-in: boxes and labels into the BGR frame, then
+// back through the matching kernel into a scratch copy of the source planes.
+void DrawOverlay(cv::Mat *bgr, const std::vector<DetectedFace> &faces)
+{
+  for (const DetectedFace &face : faces) {
+    const cv::Rect bbox = face.bbox & cv::Rect(0, 0, bgr->cols, bgr->rows);
+    if (bbox.empty()) {
+      continue;
+    }
+    cv::rectangle(*bgr, bbox, cv::Scalar(0, 255, 0), 2, cv::LINE_AA);
+    cv::putText(
+      *bgr, EmotionToFrenchLabel(face.label), cv::Point(bbox.x, std::max(0, bbox.y - 6)), cv::FONT_HERSHEY_SIMPLEX,
+      0.8, cv::Scalar(255, 255, 255), 2, cv::LINE_AA);
+  }
+}
+
+void WriteBack(const FrameView &view, const cv::Mat &bgr, std::vector<uint8_t> *scratch)
+{
+  const int width = static_cast<int>(view.header.width);
+  const int height = static_cast<int>(view.header.height);
+
+  switch (static_cast<FrameFormat>(view.header.format)) {
+  case FrameFormat::kI420:
+  case FrameFormat::kI010: {
+    scratch->resize(static_cast<std::size_t>(width) * height * 3 / 2);
+    uint8_t *y = scratch->data();
+    uint8_t *u = y + static_cast<std::size_t>(width) * height;
+    uint8_t *v = u + static_cast<std::size_t>(width / 2) * (height / 2);
+    yuv_convert::BgrToI420(
+      bgr.data, bgr.step, y, static_cast<std::size_t>(width), u, static_cast<std::size_t>(width / 2), v,
+      static_cast<std::size_t>(width / 2), width, height);
+    break;
+  }
+  case FrameFormat::kNv12:
+  case FrameFormat::kP010: {
+    scratch->resize(static_cast<std::size_t>(width) * height * 3 / 2);
+    uint8_t *y = scratch->data();
+    uint8_t *uv = y + static_cast<std::size_t>(width) * height;
+    yuv_convert::BgrToNv12(
+      bgr.data, bgr.step, y, static_cast<std::size_t>(width), uv, static_cast<std::size_t>(width), width, height);
+    break;
+  }
+  case FrameFormat::kYuy2: {
+    scratch->resize(static_cast<std::size_t>(width) * height * 2);
+    yuv_convert::BgrToYuy2(bgr.data, bgr.step, scratch->data(), static_cast<std::size_t>(width) * 2, width, height);
+    break;
+  }
+  case FrameFormat::kBgra: {
+    scratch->resize(static_cast<std::size_t>(width) * height * 4);
+    cv::Mat bgra(height, width, CV_8UC4, scratch->data(), static_cast<std::size_t>(width) * 4);
+    cv::cvtColor(bgr, bgra, cv::COLOR_BGR2BGRA);
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+std::size_t PeakRssBytes()
+{
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters = {};
+  GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+  return counters.PeakWorkingSetSize;
+#elif defined(__APPLE__)
+  struct rusage usage = {};
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+  struct rusage usage = {};
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+double MillisecondsSince(const std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(
+           std::chrono::steady_clock::now() - start)
+    .count();
+}
+
+void PrintUsage()
+{
+  std::fprintf(
+    stderr,
+    "usage: face-emotion-replay <dump-file> --face-model <path> --emotion-model <path>\n"
+    "                           [--loops N] [--inference-width W] [--max-faces N]\n");
+}
+
+} // namespace
+
+int main(const int argc, const char **argv)
+{
+  const char *dump_path = nullptr;
+  std::string face_model;
+  std::string emotion_model;
+  int loops = 1;
+  InferenceWorker::Config config;
+
+  for (int arg = 1; arg < argc; ++arg) {
+    const std::string option = argv[arg];
+    if (option == "--face-model" && arg + 1 < argc) {
+      face_model = argv[++arg];
+    } else if (option == "--emotion-model" && arg + 1 < argc) {
+      emotion_model = argv[++arg];
+    } else if (option == "--loops" && arg + 1 < argc) {
+      loops = std::max(1, std::atoi(argv[++arg]));
+    } else if (option == "--inference-width" && arg + 1 < argc) {
+      config.inference_width = std::max(160, std::atoi(argv[++arg]));
+    } else if (option == "--max-faces" && arg + 1 < argc) {
+      config.max_faces = std::clamp(std::atoi(argv[++arg]), 1, 16);
+    } else if (dump_path == nullptr) {
+      dump_path = argv[arg];
+    } else {
+      PrintUsage();
+      return 1;
+    }
+  }
+
+  if (dump_path == nullptr || face_model.empty() || emotion_model.empty()) {
+    PrintUsage();
+    return 1;
+  }
+
+  MappedFile dump;
+  if (!dump.Open(dump_path) || dump.size < sizeof(FileHeader)) {
+    std::fprintf(stderr, "cannot map %s\n", dump_path);
+    return 1;
+  }
+
+  FileHeader file_header;
+  std::memcpy(&file_header, dump.data, sizeof(file_header));
+  if (std::memcmp(file_header.magic, kMagic, sizeof(kMagic)) != 0 || file_header.version != 1) {
+    std::fprintf(stderr, "%s is not a version-1 FERDUMP file\n", dump_path);
+    return 1;
+  }
+
+  InferenceWorker worker;
+  std::string error;
+  if (!worker.Start(face_model, emotion_model, config, &error)) {
+    std::fprintf(stderr, "worker start failed: %s\n", error.c_str());
+    return 1;
+  }
+  const InferenceWorker::ClientId client_id = worker.RegisterClient(config);
+  while (worker.IsRunning() && !worker.IsReady()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  if (!worker.IsRunning()) {
+    std::fprintf(stderr, "model loading failed\n");
+    return 1;
+  }
+
+  double extract_ms = 0.0;
+  double submit_ms = 0.0;
+  double overlay_ms = 0.0;
+  double writeback_ms = 0.0;
+  uint64_t frames = 0;
+  uint64_t results = 0;
+
+  cv::Mat bgr;
+  std::vector<DetectedFace> latest_faces;
+  std::vector<uint8_t> writeback_scratch;
+  const auto run_start = std::chrono::steady_clock::now();
+
+  for (int loop = 0; loop < loops; ++loop) {
+    std::size_t offset = sizeof(FileHeader);
+    while (offset + sizeof(FrameHeader) <= dump.size) {
+      FrameView view;
+      std::memcpy(&view.header, dump.data + offset, sizeof(FrameHeader));
+      offset += sizeof(FrameHeader);
+      if (offset + view.header.data_size > dump.size ||
+          !ResolvePlanes(&view, dump.data + offset, view.header.data_size)) {
+        std::fprintf(stderr, "truncated frame at offset %zu\n", offset);
+        break;
+      }
+      offset += view.header.data_size;
+
+      auto stage_start = std::chrono::steady_clock::now();
+      if (!ExtractBgr(view, &bgr)) {
+        continue;
+      }
+      extract_ms += MillisecondsSince(stage_start);
+
+      // Monotonic synthetic timestamps so looping the dump never rewinds the
+      // tracker clock.
+      const uint64_t timestamp_ns =
+        view.header.timestamp_ns + static_cast<uint64_t>(loop) * 60ULL * 1'000'000'000ULL;
+
+      stage_start = std::chrono::steady_clock::now();
+      worker.SubmitFrame(client_id, bgr, timestamp_ns, bgr.cols, bgr.rows);
+      std::vector<DetectedFace> faces;
+      if (worker.TryConsumeLatest(client_id, &faces, nullptr, nullptr)) {
+        latest_faces = std::move(faces);
+        ++results;
+      }
+      submit_ms += MillisecondsSince(stage_start);
+
+      stage_start = std::chrono::steady_clock::now();
+      DrawOverlay(&bgr, latest_faces);
+      overlay_ms += MillisecondsSince(stage_start);
+
+      stage_start = std::chrono::steady_clock::now();
+      WriteBack(view, bgr, &writeback_scratch);
+      writeback_ms += MillisecondsSince(stage_start);
+
+      ++frames;
+    }
+  }
+
+  const double total_seconds = MillisecondsSince(run_start) / 1000.0;
+  worker.UnregisterClient(client_id);
+  worker.Stop();
+
+  if (frames == 0) {
+    std::fprintf(stderr, "no frames replayed\n");
+    return 1;
+  }
+
+  const double per_frame = static_cast<double>(frames);
+  std::printf("frames:          %llu (%llu inference results)\n",
+              static_cast<unsigned long long>(frames), static_cast<unsigned long long>(results));
+  std::printf("sustained fps:   %.1f\n", static_cast<double>(frames) / total_seconds);
+  std::printf("extract:         %.3f ms/frame\n", extract_ms / per_frame);
+  std::printf("submit+consume:  %.3f ms/frame\n", submit_ms / per_frame);
+  std::printf("overlay:         %.3f ms/frame\n", overlay_ms / per_frame);
+  std::printf("write-back:      %.3f ms/frame\n", writeback_ms / per_frame);
+  std::printf("peak rss:        %.1f MiB\n", static_cast<double>(PeakRssBytes()) / (1024.0 * 1024.0));
+  return 0;
+}
+
+// Stand-ins for the libobs logging symbols inference_worker.cpp uses through
+// plugin-support.h; the harness logs to stderr instead.
+extern "C" {
+
+const char *PLUGIN_NAME = "face-emotion-replay";
+const char *PLUGIN_VERSION = "dev";
+
+void obs_log(const int log_level, const char *format, ...)
+{
+  (void)log_level;
+  va_list args;
+  va_start(args, format);
+  std::vfprintf(stderr, format, args);
+  std::fputc('\n', stderr);
+  va_end(args);
+}
+
+} // extern "C"